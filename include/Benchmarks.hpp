@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+
+// Micro-benchmarks for the indexing pipeline.
+// Run as: main bench <name> <path>
+// Each benchmark prints its own timings and returns false on failure.
+
+// DOM vs SAX body extraction over every *.json file under json_dir
+bool bench_body_extraction(const std::string& json_dir);
+
+// preprocess() vs fused preprocessInto(): equivalence + tokens/sec
+bool bench_tokenizer(const std::string& json_dir);
+
+// Scalar / SSE2 / AVX2 lowercase + word-split kernels in GB/s
+bool bench_char_class(const std::string& json_dir);
+
+// Compile-time StopWordTable vs std::unordered_set<std::string> lookups
+bool bench_stop_words(const std::string& json_dir);
+
+// Stemming with and without a (shared, multi-threaded) StemCache
+bool bench_stem_cache(const std::string& json_dir);
+
+// Porter stemmer conformance against reference output + words/sec
+bool bench_porter_stemmer(const std::string& path);
+
+// Lexicon memory (bytes/term) and lookups/sec, node map vs TermTable
+bool bench_lexicon(const std::string& json_dir);
+
+// IndexBuilder with 1 vs several threads over batches holding duplicate
+// cord_uids: build time and byte-identical lexicon / forward index
+bool bench_parallel_build(const std::string& json_dir);
+
+// Startup and lookups: lexicon.csv vs memory-mapped lexicon.bin
+bool bench_lexicon_load(const std::string& indices_dir);
+
+// FST lexicon: bytes/term vs hash layouts, lookups and prefix scans
+bool bench_fst_lexicon(const std::string& json_dir);
+
+// Forward index term storage: per-document vectors vs CSR, memory and full scan
+bool bench_forward_layout(const std::string& json_dir);
+
+// Compressed document store: ratio, sequential and random fetch time
+bool bench_document_store(const std::string& indices_dir);
+
+// forward_index.bin: bulk load vs in-place MappedForwardIndex, cold and warm open
+bool bench_forward_load(const std::string& indices_dir);
+
+// Copying index getters vs zero-copy views and visitors, full-corpus scale
+bool bench_index_views(const std::string& indices_dir);
+
+// Run a benchmark by name; returns a process exit code
+int run_benchmark(const std::string& name, const std::string& path);
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ASCII case folding and word/separator classification kernels.
+// A word byte is [A-Za-z0-9] (what std::isalnum accepts in the "C" locale);
+// everything else, including all non-ASCII bytes, is a separator.
+// The widest kernel the CPU supports (AVX2, SSE2, scalar) is picked once at
+// startup; set_kernel() overrides it for benchmarking.
+class CharClass {
+public:
+    enum Kernel { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+    
+    // dst[i] = lowercase(src[i]) for ASCII letters, other bytes copied as is.
+    // dst may equal src.
+    static void to_lower(const char* src, char* dst, size_t n);
+    
+    // Bit i is set when s[i] is a word byte, for i < n (n <= 64)
+    static uint64_t word_mask(const char* s, size_t n);
+    
+    static bool is_word_char(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return static_cast<unsigned char>(u - '0') < 10 ||
+               static_cast<unsigned char>((u | 0x20) - 'a') < 26;
+    }
+    
+    // Calls on_word(begin, length) for every maximal run of word bytes in s
+    template <typename OnWord>
+    static void for_each_word(const char* s, size_t n, OnWord&& on_word);
+    
+    static Kernel get_kernel();
+    static bool set_kernel(Kernel kernel);   // false if the CPU lacks it
+    static bool is_supported(Kernel kernel);
+    static const char* kernel_name(Kernel kernel);
+};
+
+template <typename OnWord>
+void CharClass::for_each_word(const char* s, size_t n, OnWord&& on_word) {
+    bool in_word = false;
+    size_t word_start = 0;
+    
+    // Classify 64 bytes at a time, then walk the run boundaries with bit scans
+    for (size_t base = 0; base < n; base += 64) {
+        size_t len = (n - base < 64) ? n - base : 64;
+        uint64_t valid = (len == 64) ? ~0ULL : ((1ULL << len) - 1);
+        uint64_t words = word_mask(s + base, len);
+        uint64_t separators = ~words & valid;
+        
+        size_t i = 0;
+        while (i < len) {
+            uint64_t rest = (in_word ? separators : words) >> i;
+            if (rest == 0) break;   // current state lasts to the end of the block
+            
+            i += static_cast<size_t>(__builtin_ctzll(rest));
+            if (in_word) {
+                on_word(s + word_start, base + i - word_start);
+            } else {
+                word_start = base + i;
+            }
+            in_word = !in_word;
+        }
+    }
+    
+    if (in_word) {
+        on_word(s + word_start, n - word_start);
+    }
+}
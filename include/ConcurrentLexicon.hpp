@@ -0,0 +1,62 @@
+#pragma once
+#include "TermTable.hpp"
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// Lexicon that many tokenizer threads can extend at once.
+// Terms are sharded by hash, each shard behind its own mutex. A new term
+// gets a provisional id straight away (dense, but dependent on thread
+// scheduling) and remembers where it was first seen. finalize() then
+// hands out the real word ids in first-seen order, so the ids are the
+// same as a sequential pass over the corpus would assign, on every run.
+class ConcurrentLexicon {
+public:
+    explicit ConcurrentLexicon(size_t num_shards = 64);
+    
+    // first_seen key of token position of document doc_seq
+    static uint64_t make_first_seen(uint64_t doc_seq, uint32_t position) {
+        return (doc_seq << 32) | position;
+    }
+    
+    // Thread-safe. Provisional id of word, adding it if new. first_seen
+    // lowers the term's first-seen key if it is earlier than the stored one.
+    uint32_t add_word(std::string_view word, uint64_t first_seen);
+    
+    // Not thread-safe (no add_word may run concurrently). Gives every term
+    // added since the previous call its final id, in first_seen order and
+    // after all ids handed out before. Returns the number of new terms.
+    size_t finalize();
+    
+    // Only valid for finalized terms
+    uint32_t get_final_id(uint32_t provisional_id) const { return final_ids[provisional_id]; }
+    std::string_view get_word(uint32_t final_id) const;
+    
+    // Number of finalized terms
+    size_t get_size() const { return final_locations.size(); }
+    
+    void clear();
+    
+private:
+    struct Shard {
+        std::mutex lock;
+        TermTable terms;
+        std::vector<uint32_t> provisional_ids;   // term index -> provisional id
+        std::vector<uint64_t> first_seen;        // term index -> earliest position key
+        std::vector<uint32_t> pending;           // term indexes not finalized yet
+    };
+    
+    struct Location {
+        uint32_t shard;
+        uint32_t index;
+    };
+    
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<uint32_t> next_provisional_id;
+    
+    std::vector<uint32_t> final_ids;             // provisional id -> final id
+    std::vector<Location> final_locations;       // final id -> term
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+// RFC 4180 reader over a memory-mapped CSV file.
+// Handles quoted fields with embedded commas/newlines and "" escapes.
+// Fields are returned as views into the mapping; nothing is allocated per
+// field except when an escaped quote has to be collapsed.
+class CsvReader {
+public:
+    CsvReader();
+    
+    // Map the file and (optionally) read the first record as the header
+    bool open(const std::string& path, bool has_header = true);
+    void close();
+    
+    // Advance to the next non-empty record; false at end of file
+    bool next_row();
+    
+    size_t field_count() const { return fields.size(); }
+    
+    // Field contents without the surrounding quotes ("" escapes left as is)
+    std::string_view field(size_t i) const;
+    
+    // Field with "" collapsed to "; scratch is only used when needed
+    std::string_view field_unescaped(size_t i, std::string& scratch) const;
+    
+    // Column index by header name, or -1 if missing
+    int column_index(const std::string& name) const;
+    const std::vector<std::string>& get_header() const { return header; }
+    
+    // 1-based record number of the current row (header = record 1)
+    size_t get_record_number() const { return record_number; }
+    
+private:
+    struct FieldSpan {
+        const char* begin;
+        size_t length;
+        bool has_escapes;   // contains "" inside a quoted field
+    };
+    
+    MappedFile file;
+    const char* pos;
+    const char* end;
+    std::vector<FieldSpan> fields;    // reused for every row
+    std::vector<std::string> header;
+    std::unordered_map<std::string, int> columns;
+    size_t record_number;
+    
+    // Parse one record starting at pos into fields
+    void parse_record();
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+// Stored (display-only) fields of one paper
+struct StoredDocument {
+    std::string paper_id;
+    std::string title;
+    std::string authors;
+    std::string publish_date;
+    std::string abstract_text;
+};
+
+// documents.bin: the stored fields of every indexed paper, kept apart from
+// the forward index so term-only runs never read them. Documents are packed
+// in internal doc id order into blocks of about BLOCK_BYTES; each block is
+// compressed on its own (byte-oriented LZ77), so showing one result costs
+// one block decompression.
+//
+// File layout (native little-endian):
+//   Header
+//   compressed blocks, back to back
+//   BlockEntry table[block_count]        at header.table_offset
+// Inside a block every document is its five fields in StoredDocument
+// order, each a varint length followed by the bytes.
+class DocumentStoreWriter {
+public:
+    static constexpr size_t BLOCK_BYTES = 8 * 1024;
+
+    DocumentStoreWriter() = default;
+    ~DocumentStoreWriter() { close(); }
+
+    DocumentStoreWriter(const DocumentStoreWriter&) = delete;
+    DocumentStoreWriter& operator=(const DocumentStoreWriter&) = delete;
+
+    bool open(const std::string& path);
+    bool is_open() const { return out.is_open(); }
+
+    // Append the next document; its id is the number of documents before it
+    void add_document(std::string_view paper_id, std::string_view title, std::string_view authors,
+                      std::string_view publish_date, std::string_view abstract_text);
+
+    // Flush the last block and write the block table; the counts below
+    // stay readable afterwards (until the next open)
+    bool close();
+
+    uint32_t get_document_count() const { return document_count; }
+    uint64_t get_raw_bytes() const { return raw_bytes; }
+    uint64_t get_compressed_bytes() const { return compressed_bytes; }
+
+private:
+    std::ofstream out;
+    std::string block;            // raw bytes of the block being filled
+    std::string compressed;       // scratch for its compressed form
+    std::vector<char> table;      // serialized block entries
+    uint32_t document_count = 0;
+    uint32_t block_first_doc = 0;
+    uint32_t block_count = 0;
+    uint64_t raw_bytes = 0;
+    uint64_t compressed_bytes = 0;
+
+    bool flush_block();
+};
+
+// Read side: maps documents.bin and decompresses blocks on demand
+class DocumentStore {
+public:
+    DocumentStore() = default;
+
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return file.is_open(); }
+
+    // Fields of internal doc id doc_id; false if unknown or corrupt.
+    // The most recently used block stays decompressed.
+    bool get_document(uint32_t doc_id, StoredDocument& doc);
+
+    size_t get_size() const { return document_count; }
+    size_t get_block_count() const { return blocks.size(); }
+    size_t get_file_bytes() const { return file.size(); }
+
+private:
+    struct Block {
+        uint64_t offset;
+        uint32_t compressed_bytes;
+        uint32_t raw_bytes;
+        uint32_t first_doc;
+    };
+
+    MappedFile file;
+    std::vector<Block> blocks;
+    uint32_t document_count = 0;
+    int cached_block = -1;
+    std::string cache;            // decompressed bytes of cached_block
+
+    bool load_block(size_t index);
+};
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <cstdint>
 #include <fstream>
+#include <cstddef>
 
 // Simple structure to hold word_id and frequency (no positions)
 struct TermPosting {
@@ -15,25 +16,68 @@ struct TermPosting {
     TermPosting(uint32_t id, uint32_t freq) : word_id(id), frequency(freq) {}
 };
 
+// Read-only view of one document's term list inside the forward index's
+// CSR arrays (word ids and frequencies stored as two parallel columns).
+// Valid until the next add_document / load / clear.
+class TermList {
+public:
+    class iterator {
+    public:
+        iterator(const uint32_t* word_id, const uint32_t* frequency)
+            : word_id(word_id), frequency(frequency) {}
+        TermPosting operator*() const { return TermPosting(*word_id, *frequency); }
+        iterator& operator++() { ++word_id; ++frequency; return *this; }
+        bool operator!=(const iterator& other) const { return word_id != other.word_id; }
+        bool operator==(const iterator& other) const { return word_id == other.word_id; }
+    private:
+        const uint32_t* word_id;
+        const uint32_t* frequency;
+    };
+    
+    TermList() : ids(nullptr), freqs(nullptr), count(0) {}
+    TermList(const uint32_t* word_ids, const uint32_t* frequencies, size_t count)
+        : ids(word_ids), freqs(frequencies), count(count) {}
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    TermPosting operator[](size_t i) const { return TermPosting(ids[i], freqs[i]); }
+    
+    // Columns, sorted by word id
+    const uint32_t* word_ids() const { return ids; }
+    const uint32_t* frequencies() const { return freqs; }
+    
+    iterator begin() const { return iterator(ids, freqs); }
+    iterator end() const { return iterator(ids + count, freqs + count); }
+    
+private:
+    const uint32_t* ids;
+    const uint32_t* freqs;
+    size_t count;
+};
+
 // Structure representing a single document in the forward index
+// (its terms live in the index's CSR arrays, see ForwardIndex::get_document_terms;
+// title, abstract and other display fields live in the DocumentStore)
 struct DocumentIndex {
     std::string doc_id;           // Paper ID (cord_uid)
-    std::string title;            // Document title
-    std::string abstract_text;    // Abstract text
     uint32_t doc_length;          // Total number of terms in document
-    std::vector<TermPosting> terms; // All terms in this document
     
     DocumentIndex() : doc_length(0) {}
 };
 
 class ForwardIndex {
 private:
-    // Maps document_id (cord_uid) -> document index data
-    std::unordered_map<std::string, DocumentIndex> forward_index;
+    // Documents indexed by internal numeric id (0, 1, 2, ... in insertion order)
+    std::vector<DocumentIndex> documents;
     
-    // Maps doc_id -> internal numeric document ID
+    // Maps doc_id (cord_uid) -> internal numeric document ID
     std::unordered_map<std::string, uint32_t> doc_id_map;
-    uint32_t next_doc_id;
+    
+    // Term lists of all documents back to back (CSR): document i owns
+    // entries [term_offsets[i], term_offsets[i+1]) of both columns
+    std::vector<uint32_t> term_offsets;
+    std::vector<uint32_t> term_word_ids;
+    std::vector<uint32_t> term_frequencies;
     
     // Statistics
     uint32_t total_documents;
@@ -42,19 +86,45 @@ private:
 public:
     ForwardIndex();
     
-    // Add a document to the forward index
-    void add_document(const std::string& doc_id,
-                     const std::string& title,
-                     const std::string& abstract_text,
+    // Add a document to the forward index; false if doc_id is already indexed
+    bool add_document(const std::string& doc_id,
                      const std::vector<uint32_t>& word_ids);
     
+    // Add a document whose term postings are already counted and sorted by word_id
+    // (they are copied into the CSR arrays, so the caller can reuse the vector)
+    bool add_document(const std::string& doc_id,
+                     const std::vector<TermPosting>& terms,
+                     uint32_t doc_length);
+    
     // Get document index by doc_id
     const DocumentIndex* get_document(const std::string& doc_id) const;
-
-   std::unordered_map<std::string, DocumentIndex> get_forward_index() const;
     
-    // Get all terms for a specific document
-    const std::vector<TermPosting>* get_document_terms(const std::string& doc_id) const;
+    // O(1) lookups by internal id (nullptr / UINT32_MAX when unknown)
+    const DocumentIndex* get_document_by_id(uint32_t internal_id) const {
+        return internal_id < documents.size() ? &documents[internal_id] : nullptr;
+    }
+    uint32_t get_internal_id(const std::string& doc_id) const;
+    
+    // All documents, indexed by internal id
+    const std::vector<DocumentIndex>& get_documents() const { return documents; }
+    
+    // Calls visit(internal_id, const DocumentIndex&, TermList) for every
+    // document in id order, without copying anything
+    template <typename Visitor>
+    void for_each_document(Visitor&& visit) const {
+        for (uint32_t id = 0; id < documents.size(); id++) {
+            visit(id, documents[id], get_document_terms_by_id(id));
+        }
+    }
+    
+    // Get all terms for a specific document (empty when unknown)
+    TermList get_document_terms(const std::string& doc_id) const;
+    TermList get_document_terms_by_id(uint32_t internal_id) const {
+        if (internal_id >= documents.size()) return TermList();
+        uint32_t first = term_offsets[internal_id];
+        return TermList(term_word_ids.data() + first, term_frequencies.data() + first,
+                        term_offsets[internal_id + 1] - first);
+    }
     
     // Get document length
     uint32_t get_document_length(const std::string& doc_id) const;
@@ -64,20 +134,26 @@ public:
     
     // Get statistics
     uint32_t get_total_documents() const { return total_documents; }
-    uint32_t get_total_terms() const { return total_terms; }
-    size_t get_index_size() const { return forward_index.size(); }
+    uint64_t get_total_terms() const { return total_terms; }
+    size_t get_index_size() const { return documents.size(); }
     
-    // Save forward index to binary file
+    // Save forward index to binary file in the MappedForwardIndex layout
+    // (CSR columns as held in memory, documents in internal id order)
     bool save_to_binary(const std::string& file_path);
-    std::unordered_map<std::string, uint32_t> get_doc_id_map();
+    const std::unordered_map<std::string, uint32_t>& get_doc_id_map() const { return doc_id_map; }
     
-    // Load forward index from binary file
+    // Load forward index from binary file: maps it and copies the columns
+    // in bulk (use MappedForwardIndex directly to query without loading)
     bool load_from_binary(const std::string& file_path);
     
     // Save forward index to CSV (human-readable format)
     void save_to_csv(const std::string& file_path);
     void save_first_n_to_csv(const std::string& file_path, size_t number_of_docs);
     
+    // Rewrite every posting's word_id through old_to_new (indexed by old id)
+    // and restore the word_id order of each document
+    void remap_word_ids(const std::vector<uint32_t>& old_to_new);
+    
     // Clear the index
     void clear();
     
@@ -86,5 +162,11 @@ public:
     
     // Get average document length
     double get_average_doc_length() const;
+    
+    // Heap bytes held by the CSR term arrays
+    size_t get_term_memory_bytes() const;
+    
+    // Release the growth slack of the CSR arrays once no more documents come
+    void shrink_to_fit();
 };
 
@@ -0,0 +1,72 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+// Lexicon as a minimal acyclic finite-state transducer: term -> word id.
+// Built incrementally from the sorted vocabulary (Daciuk et al.), so shared
+// prefixes and suffixes are stored once; word ids are spread over the arcs
+// as outputs whose sum along a term's path is its id. Terms are enumerated
+// in byte order, which gives prefix queries and range scans.
+//
+// Nodes are byte-packed: flags, arc count, final output, then the arc
+// labels followed by fixed-width (per node) outputs and target offsets.
+// The same bytes are used in memory and in lexicon.fst, which is mapped
+// rather than parsed.
+class FstLexicon {
+public:
+    static constexpr uint32_t VERSION = 1;
+    
+    // Longest term build() keeps; longer ones (encoded blobs rather than
+    // words) are skipped and counted
+    static constexpr size_t MAX_TERM_BYTES = 16 * 1024;
+    
+    // Called per term in byte order; return false to stop
+    using Visitor = std::function<bool(std::string_view word, uint32_t word_id)>;
+    
+    FstLexicon() = default;
+    
+    // Build from (term, word_id) pairs in any order. Empty terms and terms
+    // over MAX_TERM_BYTES are left out (see get_skipped_terms()); a repeated
+    // term returns false and leaves the FST empty.
+    bool build(std::vector<std::pair<std::string_view, uint32_t>> terms);
+    
+    bool save(const std::string& path) const;
+    bool open(const std::string& path);
+    
+    // Word id of word, or UINT32_MAX
+    uint32_t get_word_id(std::string_view word) const;
+    bool contains(std::string_view word) const { return get_word_id(word) != UINT32_MAX; }
+    
+    // Terms starting with prefix; returns how many were visited
+    size_t for_each_prefix(std::string_view prefix, const Visitor& visitor) const;
+    
+    // Terms in [first, last); an empty last means no upper bound
+    size_t for_each_in_range(std::string_view first, std::string_view last,
+                             const Visitor& visitor) const;
+    
+    size_t get_size() const { return term_count; }
+    size_t get_node_count() const { return node_count; }
+    size_t get_memory_bytes() const { return byte_count; }
+    
+    // Terms the last build() left out
+    size_t get_skipped_terms() const { return skipped_terms; }
+    
+private:
+    std::vector<uint8_t> owned;   // built in memory
+    MappedFile file;              // or opened from lexicon.fst
+    const uint8_t* bytes = nullptr;
+    size_t byte_count = 0;
+    uint32_t root = 0;
+    uint32_t term_count = 0;
+    uint32_t node_count = 0;
+    size_t skipped_terms = 0;
+    
+    bool walk(uint32_t start, bool tight, uint32_t output,
+              std::string& path, std::string_view first, std::string_view last,
+              const Visitor& visitor, size_t& visited) const;
+};
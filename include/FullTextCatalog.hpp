@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <unordered_set>
+#include <atomic>
+#include <cstdint>
+
+// Resolved full-text JSON files for one metadata row (empty = not available)
+struct FullTextFiles {
+    std::string pdf_path;   // pdf_json/{sha}.json
+    std::string pmc_path;   // pmc_json/{pmcid}.xml.json
+};
+
+// One-time listing of the pdf_json / pmc_json directories.
+// Replaces per-row fs::exists probes with hash lookups and resolves
+// multi-valued sha fields ("sha1; sha2"). Lookups are thread-safe once
+// build() has returned.
+class FullTextCatalog {
+public:
+    FullTextCatalog();
+    
+    // Scan both directories once; missing directories count as empty
+    void build(const std::string& pdf_dir, const std::string& pmc_dir);
+    bool is_built() const { return built; }
+    
+    // Path of the first sha in sha_field that has a pdf_json file, or ""
+    std::string resolve_pdf(const std::string& sha_field) const;
+    
+    // Path of the pmc_json file for pmcid, or ""
+    std::string resolve_pmc(const std::string& pmcid) const;
+    
+    // Resolve both sources for a metadata row and record coverage statistics
+    FullTextFiles resolve(const std::string& sha_field, const std::string& pmcid);
+    
+    size_t get_pdf_count() const { return pdf_files.size(); }
+    size_t get_pmc_count() const { return pmc_files.size(); }
+    
+    void reset_statistics();
+    void print_statistics() const;
+    
+private:
+    std::string pdf_dir;
+    std::string pmc_dir;
+    std::unordered_set<std::string> pdf_files;  // file stems ({sha})
+    std::unordered_set<std::string> pmc_files;  // file stems ({pmcid})
+    bool built;
+    
+    // Coverage statistics gathered by resolve()
+    std::atomic<uint64_t> rows;
+    std::atomic<uint64_t> rows_with_pdf;
+    std::atomic<uint64_t> rows_with_pmc_only;
+    std::atomic<uint64_t> multi_sha_rows;
+    std::atomic<uint64_t> multi_sha_later_match;  // matched on a sha other than the first
+    
+    // Returns the matching sha and its position in the field (or -1)
+    std::string match_sha(const std::string& sha_field, int& position) const;
+};
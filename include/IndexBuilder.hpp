@@ -0,0 +1,121 @@
+#pragma once
+#include "metadataparser.hpp"
+#include "TextPreProcessor.hpp"
+#include "LexiconBuilder.hpp"
+#include "ForwardIndex.hpp"
+#include "InvertedIndex.hpp"
+#include "TokenSinks.hpp"
+#include "ConcurrentLexicon.hpp"
+#include "DocumentStore.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+
+// Single-pass indexing pipeline.
+// Each paper is tokenized exactly once: word ids are assigned on first sight
+// and the document's forward postings are recorded in the same pass. The
+// inverted index and barrels are then derived from the forward index.
+// Batches can be tokenized on several threads; word ids and all index
+// files come out identical to the single-threaded build.
+class IndexBuilder {
+public:
+    IndexBuilder();
+    
+    // Write each indexed paper's display fields (id, title, authors, date,
+    // abstract) to a compressed document store at path as it is added;
+    // without it those fields are dropped. save() finishes the file.
+    bool open_document_store(const std::string& path);
+    
+    // Tokenizer threads used by add_papers (0 = hardware concurrency)
+    void set_num_threads(unsigned threads);
+    unsigned get_num_threads() const { return num_threads; }
+    
+    // Stage 1: tokenize one paper, extend the lexicon and add its forward postings.
+    // Returns false if the paper produced no tokens or its cord_uid is
+    // already indexed (it is not indexed, and the lexicon is left as is).
+    bool add_paper(const Paper& paper);
+    
+    // Stage 1 for a batch, in order. Papers whose cord_uid is already
+    // indexed or appeared earlier in the batch are skipped untokenized.
+    // With more than one thread the rest are tokenized in parallel against
+    // a ConcurrentLexicon and committed in batch order. Returns the number
+    // of papers indexed.
+    int add_papers(const std::vector<Paper>& papers);
+    
+    // Stage 1b (optional): renumber word ids by descending collection
+    // frequency, so the hottest terms get the smallest ids and land in the
+    // first barrel. Rewrites the lexicon and forward index; an inverted
+    // index that was already built is rebuilt (barrels must be recreated).
+    void renumber_by_frequency();
+    
+    // Stage 2: invert the forward index and record each term's
+    // df / cf / max tf / posting bytes in the lexicon
+    void build_inverted_index();
+    
+    // Stage 3: split the inverted index into barrels
+    bool create_barrels(const std::string& barrel_dir, uint32_t num_barrels = 4);
+    
+    // Write lexicon.bin, lexicon.fst, forward_index.bin and inverted_index.bin to
+    // indices_path and close the document store
+    void save(const std::string& indices_path);
+    
+    TextPreprocessor& get_preprocessor() { return preprocessor; }
+    LexiconBuilder& get_lexicon() { return lexicon; }
+    ForwardIndex& get_forward_index() { return forward_index; }
+    InvertedIndex& get_inverted_index() { return inverted_index; }
+    ReverseLexicon& get_reverse_lexicon() { return reverse_lex; }
+    
+    uint32_t get_indexed_documents() const { return indexed_documents; }
+    
+    // Per-stage wall time and throughput
+    void print_timing() const;
+    
+private:
+    // State of one parallel tokenizer thread
+    struct TokenizerWorker {
+        TextPreprocessor preprocessor;
+        ConcurrentTermSink sink;
+        explicit TokenizerWorker(ConcurrentLexicon& lexicon) : sink(lexicon) {}
+    };
+    
+    // Tokenized paper waiting for its in-order commit; duplicates never get here
+    struct TokenizedPaper {
+        std::vector<TermPosting> terms;   // provisional word ids
+        uint32_t length = 0;
+    };
+    
+    unsigned num_threads;
+    uint64_t next_doc_seq;             // position of the next paper in the stream
+    ConcurrentLexicon shared_lexicon;
+    std::vector<std::unique_ptr<TokenizerWorker>> workers;
+    std::vector<TokenizedPaper> tokenized;
+    
+    void tokenize_parallel(const std::vector<const Paper*>& papers);
+    bool is_indexed(const Paper& paper) const;
+    bool commit_paper(const Paper& paper, TokenizedPaper& result);
+    void store_paper(const Paper& paper);
+    
+    TextPreprocessor preprocessor;
+    LexiconBuilder lexicon;
+    ForwardIndex forward_index;
+    InvertedIndex inverted_index;
+    ReverseLexicon reverse_lex;
+    DocumentStoreWriter document_store;
+    
+    DocumentTermSink term_sink;
+    std::vector<TermPosting> terms;   // postings of the paper being added
+    
+    uint32_t indexed_documents;
+    uint64_t indexed_tokens;
+    uint64_t input_bytes;
+    
+    // Stage timings in seconds
+    double tokenize_seconds;   // tokenization + lexicon id assignment
+    double forward_seconds;    // forward index insertion
+    double renumber_seconds;
+    double invert_seconds;
+    double barrel_seconds;
+    double save_seconds;
+};
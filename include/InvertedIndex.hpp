@@ -3,6 +3,29 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include "ReverseLexicon.hpp"
+
+// Read-only view of one posting list: (doc_id, frequency) pairs in doc id
+// order. Valid until the index is modified, cleared or another barrel loads.
+class PostingList
+{
+    public:
+        using Posting = std::pair<uint32_t,uint32_t>;
+
+        PostingList() : first(nullptr), count(0) {}
+        explicit PostingList(const std::vector<Posting>& postings)
+            : first(postings.data()), count(postings.size()) {}
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Posting& operator[](size_t i) const { return first[i]; }
+        const Posting* begin() const { return first; }
+        const Posting* end() const { return first + count; }
+
+    private:
+        const Posting* first;
+        size_t count;
+};
 
 class InvertedIndex
 {
@@ -23,13 +46,14 @@ class InvertedIndex
         std::vector<BarrelMetadata> barrel_metadata;  // Stores info about all barrels
         std::string barrel_directory;                  // Directory where barrels are stored
         int currently_loaded_barrel;                   // Which barrel is currently in memory (-1 = none)
+        ReverseLexicon barrel_words;                   // Words of the loaded barrel the caller's lexicon lacks
         
         // Helper: Find which barrel contains a word_id
         int find_barrel_index(uint32_t word_id) const;
         
         // Helper: Load a specific barrel by index
         bool load_barrel_by_index(int barrel_idx, 
-                                 std::unordered_map<uint32_t, std::string>& reverse_lex);
+                                 const ReverseLexicon& reverse_lex);
 
     public:
         // ===== ORIGINAL METHODS (UNCHANGED) =====
@@ -37,21 +61,43 @@ class InvertedIndex
         void add_document(uint32_t doc_id, 
             const std::vector<std::pair<uint32_t,uint32_t>>& terms);
         const std::vector<std::pair<uint32_t,uint32_t>>* get_terms(uint32_t word_id);
-        void save_to_csv(const std::string& file_path, const std::unordered_map<uint32_t, std::string>& reverse_lex) const;
+        void save_to_csv(const std::string& file_path, const ReverseLexicon& reverse_lex) const;
         void save_first_n_to_csv(const std::string& file_path,
-            const std::unordered_map<uint32_t, std::string>& reverse_lex,size_t num)const;
+            const ReverseLexicon& reverse_lex,size_t num)const;
+        // Copy of every loaded posting list; use get_postings / for_each_term
+        // to read the index in place
         std::unordered_map<uint32_t,std::vector<std::pair<uint32_t,uint32_t>>> get_inverted_index()const;
-        void save_to_binary(const std::string& file_path, const std::unordered_map<uint32_t, std::string>& reverse_lex) const;
-        bool load_from_binary(const std::string& file_path, std::unordered_map<uint32_t, std::string>& reverse_lex);
+        void save_to_binary(const std::string& file_path, const ReverseLexicon& reverse_lex) const;
+        bool load_from_binary(const std::string& file_path, ReverseLexicon& reverse_lex);
         void clear();
         void print_statistics() const;
         
+        // ===== ZERO-COPY READ API =====
+        
+        // Postings of word_id if loaded (empty otherwise, no barrel warning)
+        PostingList get_postings(uint32_t word_id) const
+        {
+            auto it = inverted_index.find(word_id);
+            return it != inverted_index.end() ? PostingList(it->second) : PostingList();
+        }
+        
+        // Calls visit(word_id, PostingList) for every loaded word, in map order
+        template <typename Visitor>
+        void for_each_term(Visitor&& visit) const
+        {
+            for (const auto& [word_id, postings] : inverted_index)
+                visit(word_id, PostingList(postings));
+        }
+        
+        // Number of loaded words
+        size_t get_term_count() const { return inverted_index.size(); }
+        
         // ===== NEW: BARREL METHODS =====
         
         // Create 4 barrels from current inverted_index
         // Splits words into 4 equal ranges by word_id
         bool create_barrels(const std::string& barrel_dir,
-                           const std::unordered_map<uint32_t, std::string>& reverse_lex,
+                           const ReverseLexicon& reverse_lex,
                            uint32_t num_barrels = 4);
         
         // Load barrel metadata (small file with ranges)
@@ -59,9 +105,18 @@ class InvertedIndex
         bool load_barrel_metadata(const std::string& barrel_dir);
         
         // Load specific barrel containing a word_id
-        // Automatically called when you need to query a word
+        // Automatically called when you need to query a word.
+        // reverse_lex is only read: words it lacks are kept with the barrel
+        // (see get_word), so an empty one works for a query process
         bool load_barrel_for_word(uint32_t word_id,
-                                 std::unordered_map<uint32_t, std::string>& reverse_lex);
+                                 const ReverseLexicon& reverse_lex);
+        
+        // Word of word_id from reverse_lex, else from the loaded barrel file
+        std::string_view get_word(uint32_t word_id, const ReverseLexicon& reverse_lex) const
+        {
+            return reverse_lex.contains(word_id) ? reverse_lex.get_word(word_id)
+                                                 : barrel_words.get_word(word_id);
+        }
         
         // Get currently loaded barrel info (-1 if none loaded)
         int get_loaded_barrel() const { return currently_loaded_barrel; }
@@ -71,5 +126,5 @@ class InvertedIndex
         
         // Export all barrels to CSV format (for submission/inspection)
         bool export_barrels_to_csv(const std::string& barrel_dir,
-                                  const std::unordered_map<uint32_t, std::string>& reverse_lex);
+                                  const ReverseLexicon& reverse_lex);
 };
\ No newline at end of file
@@ -1,25 +1,44 @@
 #pragma once
 #include <unordered_map>
+#include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include "TermTable.hpp"
+#include "ReverseLexicon.hpp"
+#include "TermStats.hpp"
 
 class LexiconBuilder
 {
     private:
-        std::unordered_map<std::string,std::pair<uint32_t,uint32_t>> lexicon_data;
+        TermTable terms;                                      // interned words
+        std::vector<std::pair<uint32_t,uint32_t>> details;    // (word_id, frequency) per term index
+        std::vector<TermStats> term_stats;                    // per word id, filled by set_term_stats
         int next_word_id;
     public:
         LexiconBuilder();
-        uint32_t add_word(const std::string& word,uint32_t count);
-        bool contains(const std::string& word);
-        const std::pair<uint32_t,uint32_t>* get_word_details(const std::string& word);
-        uint32_t get_frequency(const std::string& word)const;
-        uint32_t get_word_id(const std::string& word)const;
+        uint32_t add_word(std::string_view word,uint32_t count);
+        bool contains(std::string_view word)const;
+        const std::pair<uint32_t,uint32_t>* get_word_details(std::string_view word);
+        uint32_t get_frequency(std::string_view word)const;
+        uint32_t get_word_id(std::string_view word)const;
         size_t get_size()const;
+        // df / cf / max tf / posting bytes in O(1); nullptr until the index
+        // has been inverted (see IndexBuilder::build_inverted_index)
+        void set_term_stats(uint32_t word_id, const TermStats& stats);
+        const TermStats* get_term_stats(uint32_t word_id)const;
+        const TermStats* get_term_stats(std::string_view word)const;
         void save_to_csv(const std::string& csv_path);
         bool load_from_csv(const std::string& csv_path);
-        std::unordered_map<uint32_t,std::string>build_reverse_lexicon();
+        bool save_to_binary(const std::string& bin_path);   // lexicon.bin, see MappedLexicon
+        bool load_from_binary(const std::string& bin_path);
+        bool save_to_fst(const std::string& fst_path);      // lexicon.fst, see FstLexicon
+        ReverseLexicon build_reverse_lexicon()const;
+        // reassign ids by descending frequency (ties keep the old order);
+        // returns old id -> new id, UINT32_MAX for ids that were never used
+        std::vector<uint32_t> renumber_by_frequency();
         void clear_lexicon();
+        size_t get_memory_bytes()const;   // heap bytes held by the lexicon
 
     
 
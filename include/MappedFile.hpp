@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Read-only, contiguous view of a whole file.
+// The file is memory-mapped when possible; otherwise (mmap failure, empty
+// or special files) it is read with pread into an owned buffer. Reusing one
+// MappedFile per thread keeps that buffer's capacity across files.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Opens path, closing any previously open file. Returns false on error.
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return open_flag; }
+    bool is_mapped() const { return map_data != nullptr; }
+    const char* data() const { return map_data ? map_data : buffer.data(); }
+    size_t size() const { return file_size; }
+    std::string_view view() const { return std::string_view(data(), file_size); }
+
+private:
+    const char* map_data = nullptr;  // mmap'd region (nullptr when using buffer)
+    size_t file_size = 0;
+    bool open_flag = false;
+    std::string buffer;              // pread fallback storage
+
+    bool read_into_buffer(const std::string& path);
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "ForwardIndex.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Read-only forward index served straight from a memory-mapped
+// forward_index.bin. Opening maps and validates the file; documents are
+// then queried in place by internal id (or by cord_uid through the
+// stored hash index) without building any per-document objects.
+//
+// File layout (version 4, native little-endian, every section 8-byte aligned):
+//   Header
+//   uint32 doc_lengths[document_count]
+//   uint32 term_offsets[document_count + 1]   CSR row starts into the two columns
+//   uint32 word_ids[posting_count]            per document, sorted by word id
+//   uint32 frequencies[posting_count]
+//   uint32 id_offsets[document_count + 1]     cord_uid i = ids[off[i], off[i+1])
+//   Slot   slots[slot_count]                  open-addressing cord_uid -> internal id
+//   char   ids[id_bytes]
+class MappedForwardIndex {
+public:
+    static constexpr uint32_t NPOS = UINT32_MAX;
+    static constexpr uint32_t VERSION = 4;
+
+    // Write index in this layout (ForwardIndex::save_to_binary)
+    static bool write(const std::string& path, const ForwardIndex& index);
+
+    MappedForwardIndex() = default;
+
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return file.is_open(); }
+
+    // O(1) by internal id; empty list / 0 / empty view when unknown
+    TermList get_document_terms_by_id(uint32_t internal_id) const {
+        if (internal_id >= document_count) return TermList();
+        uint32_t first = term_offsets[internal_id];
+        return TermList(word_ids + first, frequencies + first, term_offsets[internal_id + 1] - first);
+    }
+    uint32_t get_document_length(uint32_t internal_id) const {
+        return internal_id < document_count ? doc_lengths[internal_id] : 0;
+    }
+    std::string_view get_doc_id(uint32_t internal_id) const {
+        if (internal_id >= document_count) return std::string_view();
+        return std::string_view(ids + id_offsets[internal_id], id_offsets[internal_id + 1] - id_offsets[internal_id]);
+    }
+
+    // Hash index lookup; NPOS if the cord_uid is not indexed
+    uint32_t get_internal_id(std::string_view doc_id) const;
+
+    size_t get_size() const { return document_count; }
+    uint64_t get_total_terms() const { return total_terms; }
+    uint64_t get_posting_count() const { return posting_count; }
+
+    // Raw columns, for bulk copies
+    const uint32_t* get_term_offsets() const { return term_offsets; }
+    const uint32_t* get_word_ids() const { return word_ids; }
+    const uint32_t* get_frequencies() const { return frequencies; }
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t document_count;
+        uint32_t slot_count;
+        uint64_t total_terms;
+        uint64_t posting_count;
+        uint64_t id_bytes;
+    };
+
+    struct Slot {
+        uint32_t hash;
+        uint32_t internal_id;   // NPOS = empty
+    };
+
+    // Offsets and slot ids must stay inside their sections (checked by open)
+    bool validate(uint64_t id_bytes) const;
+    
+    MappedFile file;
+    uint32_t document_count = 0;
+    uint32_t slot_count = 0;
+    uint64_t total_terms = 0;
+    uint64_t posting_count = 0;
+    const uint32_t* doc_lengths = nullptr;
+    const uint32_t* term_offsets = nullptr;
+    const uint32_t* word_ids = nullptr;
+    const uint32_t* frequencies = nullptr;
+    const uint32_t* id_offsets = nullptr;
+    const Slot* slots = nullptr;
+    const char* ids = nullptr;
+};
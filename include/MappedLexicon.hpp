@@ -0,0 +1,106 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "TermStats.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Read-only lexicon served straight from a memory-mapped lexicon.bin.
+// Opening only maps and validates the file; nothing is deserialized.
+//
+// File layout (native little-endian, every section 8-byte aligned):
+//   Header
+//   uint32 string_offsets[term_count + 1]   sorted term i = strings[off[i], off[i+1])
+//   uint32 word_ids[term_count]             per sorted term
+//   uint32 frequencies[term_count]          per sorted term (collection frequency)
+//   uint32 document_frequencies[term_count] per sorted term
+//   uint32 max_term_frequencies[term_count] per sorted term
+//   uint32 posting_bytes[term_count]        per sorted term
+//   uint32 id_to_sorted[id_count]           word id -> sorted term (NPOS = unused id)
+//   Slot   slots[slot_count]                open-addressing hash index -> sorted term
+//   char   strings[string_bytes]            terms in byte-wise sorted order
+class MappedLexicon {
+public:
+    static constexpr uint32_t NPOS = UINT32_MAX;
+    static constexpr uint32_t VERSION = 2;
+    
+    struct Entry {
+        std::string_view word;
+        uint32_t word_id;
+        uint32_t frequency;
+        uint32_t document_frequency = 0;
+        uint32_t max_term_frequency = 0;
+        uint32_t posting_bytes = 0;
+    };
+    
+    // Write entries (any order, unique words and ids) as a lexicon.bin
+    static bool write(const std::string& path, std::vector<Entry> entries);
+    
+    MappedLexicon() = default;
+    
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return file.is_open(); }
+    
+    // Hash index lookup; UINT32_MAX if the word is unknown
+    uint32_t get_word_id(std::string_view word) const;
+    uint32_t get_frequency(std::string_view word) const;
+    bool contains(std::string_view word) const { return find_sorted(word) != NPOS; }
+    
+    // O(1); empty view for unknown ids
+    std::string_view get_word(uint32_t word_id) const;
+    uint32_t get_frequency(uint32_t word_id) const;
+    
+    // O(1) df / cf / max tf / posting bytes; all zero for unknown terms
+    TermStats get_term_stats(uint32_t word_id) const;
+    TermStats get_term_stats(std::string_view word) const;
+    
+    // Terms in sorted order (for range scans and exports)
+    std::string_view get_sorted_word(uint32_t i) const {
+        return std::string_view(strings + string_offsets[i], string_offsets[i + 1] - string_offsets[i]);
+    }
+    uint32_t get_sorted_word_id(uint32_t i) const { return word_ids[i]; }
+    uint32_t get_sorted_frequency(uint32_t i) const { return frequencies[i]; }
+    
+    size_t get_size() const { return term_count; }
+    size_t get_id_count() const { return id_count; }
+    
+    // Stable across builds and platforms (the hash is stored in the file)
+    static uint32_t hash_word(std::string_view word);
+    
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t term_count;
+        uint32_t id_count;
+        uint32_t slot_count;
+        uint32_t reserved;
+        uint64_t string_bytes;
+    };
+    
+    struct Slot {
+        uint32_t hash;
+        uint32_t sorted;   // NPOS = empty
+    };
+    
+    MappedFile file;
+    uint32_t term_count = 0;
+    uint32_t id_count = 0;
+    uint32_t slot_count = 0;
+    const uint32_t* string_offsets = nullptr;
+    const uint32_t* word_ids = nullptr;
+    const uint32_t* frequencies = nullptr;
+    const uint32_t* document_frequencies = nullptr;
+    const uint32_t* max_term_frequencies = nullptr;
+    const uint32_t* posting_bytes = nullptr;
+    const uint32_t* id_to_sorted = nullptr;
+    const Slot* slots = nullptr;
+    const char* strings = nullptr;
+    
+    // Bounds of every stored offset and index, checked once by open()
+    bool validate(uint64_t string_bytes) const;
+    uint32_t find_sorted(std::string_view word) const;
+    TermStats get_sorted_stats(uint32_t i) const;
+};
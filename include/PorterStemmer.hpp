@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Porter (1980) stemmer, following Martin Porter's reference C
+// implementation (including its 'bli' -> 'ble' and 'logi' -> 'log'
+// departures from the paper). Works in place on a lowercase char buffer:
+// no allocations per word, and a stem is never longer than its word.
+class PorterStemmer {
+public:
+    // Stem word[0, length) in place; returns the length of the stem
+    static size_t stem(char* word, size_t length);
+    
+    static void stem(std::string& word) {
+        word.resize(stem(&word[0], word.size()));
+    }
+    
+    static std::string stem_copy(std::string_view word) {
+        std::string result(word);
+        stem(result);
+        return result;
+    }
+};
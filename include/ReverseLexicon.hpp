@@ -0,0 +1,46 @@
+#pragma once
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// word_id -> word for a dense id space. Every word's bytes live in one
+// blob and a vector indexed by word id holds its (offset, length) span, so
+// a lookup is one array read and the whole vocabulary is two allocations.
+// Ids that were never set read back as an empty word.
+class ReverseLexicon {
+public:
+    ReverseLexicon() = default;
+
+    // Set the word for word_id; setting the same word again is a no-op
+    void set_word(uint32_t word_id, std::string_view word);
+
+    // The word for word_id, or an empty view; valid until the next set_word()
+    std::string_view get_word(uint32_t word_id) const {
+        if (word_id >= spans.size()) return std::string_view();
+        const Span& span = spans[word_id];
+        return std::string_view(blob.data() + span.offset, span.length);
+    }
+
+    bool contains(uint32_t word_id) const {
+        return word_id < spans.size() && spans[word_id].length > 0;
+    }
+
+    // One past the largest id that can be set without growing
+    size_t size() const { return spans.size(); }
+    bool empty() const { return spans.empty(); }
+    void reserve(size_t id_count, size_t blob_bytes);
+    void clear();
+
+    // Heap bytes held by the span array and the blob
+    size_t get_memory_bytes() const;
+
+private:
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::vector<Span> spans;   // indexed by word id
+    std::vector<char> blob;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// Bounded surface form -> stem memo for the Porter stemmer.
+// Word frequencies are Zipfian, so after warm-up almost every token is a
+// hit. A hit still hashes the word, takes a shard mutex and copies the
+// stem, which is slower than the allocation-free PorterStemmer, so
+// TextPreprocessor only uses a cache that is passed to setStemCache().
+// The table is split into shards, each behind its own mutex, so one cache
+// can be shared by the preprocessors of parallel ingestion workers.
+// Once a shard is full it stops admitting new forms (the frequent ones
+// are already in by then); lookups keep working.
+class StemCache {
+public:
+    explicit StemCache(size_t capacity = 1 << 20, size_t num_shards = 16);
+    
+    // Copy the cached stem of word into stem; false on a miss
+    bool lookup(std::string_view word, std::string& stem);
+    
+    // Remember stem for word (ignored if the shard is full)
+    void insert(std::string_view word, std::string_view stem);
+    
+    void clear();
+    
+    size_t get_size() const;
+    size_t get_capacity() const { return capacity; }
+    uint64_t get_hits() const { return hits; }
+    uint64_t get_misses() const { return misses; }
+    double get_hit_rate() const;
+    
+    void reset_statistics();
+    void print_statistics() const;
+    
+private:
+    struct Shard {
+        mutable std::mutex lock;
+        std::unordered_map<std::string, std::string> stems;
+    };
+    
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t capacity;
+    size_t shard_capacity;
+    
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> rejected;   // inserts dropped because a shard was full
+    
+    Shard& shard_for(const std::string& key);
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+// Stop-word set probed with a string_view, without allocating.
+// The built-in English list is hashed into an open-addressing table at
+// compile time; each StopWordTable starts as a copy of it and custom
+// domain words can be added into the same table at startup.
+class StopWordTable {
+public:
+    struct Slot {
+        uint32_t hash = 0;
+        std::string_view word;   // empty = free slot
+    };
+    
+    // FNV-1a, usable at compile time
+    static constexpr uint32_t hash(std::string_view word) {
+        uint32_t h = 2166136261u;
+        for (char c : word) {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return h;
+    }
+    
+    StopWordTable();   // built-in English stop words
+    
+    // Copies re-point custom words at their own storage
+    StopWordTable(const StopWordTable& other);
+    StopWordTable& operator=(const StopWordTable& other);
+    
+    bool contains(std::string_view word) const {
+        if (word.size() > max_length || word.empty()) return false;
+        uint32_t h = hash(word);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.word.empty()) return false;
+            if (slot.hash == h && slot.word == word) return true;
+        }
+    }
+    
+    // Add a custom stop word (stored in the table's own arena).
+    // Returns false if it was already present or empty.
+    bool add(std::string_view word);
+    
+    // Add one word per line from a file ('#' starts a comment line).
+    // Returns the number of new words, or -1 if the file cannot be read.
+    int load_from_file(const std::string& path);
+    
+    // Drop every word, including the built-in ones
+    void clear();
+    
+    // Every word in the table, in slot order
+    std::vector<std::string_view> get_words() const;
+    
+    size_t size() const { return count; }
+    size_t get_max_length() const { return max_length; }
+    
+private:
+    std::vector<Slot> slots;           // power-of-two capacity
+    std::deque<std::string> custom;    // storage for added words (stable addresses)
+    size_t count;
+    size_t max_length;
+    
+    void insert_slot(const Slot& entry);
+    void grow();
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Per-term collection statistics, kept next to the lexicon so ranking
+// (IDF) and query planning never have to read a posting list
+struct TermStats {
+    uint32_t document_frequency = 0;     // df: documents containing the term
+    uint32_t collection_frequency = 0;   // cf: occurrences across the collection
+    uint32_t max_term_frequency = 0;     // largest tf in a single document
+    uint32_t posting_bytes = 0;          // (doc_id, frequency) payload of its posting list
+};
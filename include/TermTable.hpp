@@ -0,0 +1,51 @@
+#pragma once
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Interned set of terms: every term's bytes live in one contiguous arena
+// and a flat open-addressing table (linear probing, stored hashes) maps a
+// string_view to the term's dense index. Indexes are assigned in insertion
+// order starting at 0 and never change, so callers keep per-term data in
+// plain vectors indexed by them. Lookups never allocate.
+class TermTable {
+public:
+    static constexpr uint32_t NPOS = UINT32_MAX;
+    
+    TermTable();
+    
+    // Index of word, or NPOS
+    uint32_t find(std::string_view word) const;
+    
+    // Index of word, interning it first if it is new (inserted = true)
+    uint32_t insert(std::string_view word, bool& inserted);
+    
+    // The interned bytes of a term; valid until the next insert()
+    std::string_view get_term(uint32_t index) const {
+        return std::string_view(arena.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+    
+    size_t size() const { return offsets.size() - 1; }
+    void reserve(size_t term_count, size_t arena_bytes);
+    void clear();
+    
+    // Heap bytes held by the arena, offsets and slot array
+    size_t get_memory_bytes() const;
+    
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;   // NPOS = empty
+    };
+    
+    std::vector<char> arena;
+    std::vector<uint32_t> offsets;   // term i is arena[offsets[i], offsets[i+1])
+    std::vector<Slot> slots;         // power-of-two size, at most 3/4 full
+    
+    static uint32_t hash_term(std::string_view word);
+    bool equals(uint32_t index, std::string_view word) const {
+        return get_term(index) == word;
+    }
+    void rehash(size_t slot_count);
+};
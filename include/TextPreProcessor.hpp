@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
 #include <set>
-#include <unordered_set>
+#include "CharClass.hpp"
+#include "StopWordTable.hpp"
+#include "StemCache.hpp"
 
 class TextPreprocessor {
 public:
@@ -11,6 +15,20 @@ public:
     // Main preprocessing pipeline
     std::vector<std::string> preprocess(const std::string& text);
     
+    // Single-pass equivalent of preprocess(): lowercases, splits, filters stop
+    // words / numbers / short words and stems in one scan over text. Tokens are
+    // views into buffer, which is reused across calls (capacity is kept), so
+    // they stay valid until the next call with the same buffer.
+    void preprocessInto(std::string_view text,
+                        std::vector<std::string_view>& tokens,
+                        std::string& buffer);
+    
+    // Visitor form of the same pipeline: calls sink(std::string_view) for every
+    // token that survives filtering. The view is only valid during the call,
+    // so no token is ever materialized as a heap string.
+    template <typename Sink>
+    void forEachToken(std::string_view text, Sink&& sink);
+    
     // Individual processing steps
     std::string toLowerCase(const std::string& text);
     std::string removeSpecialChars(const std::string& text);
@@ -24,32 +42,49 @@ public:
     void setMinWordLength(int length) { min_word_length = length; }
     void setRemoveNumbers(bool remove) { remove_numbers = remove; }
     
+    // Extra domain stop words, added on top of the built-in list.
+    // loadStopWords reads one word per line; returns the number added or -1.
+    int loadStopWords(const std::string& path);
+    bool addStopWord(std::string_view word) { return stop_words.add(word); }
+    
+    // Memoize stems in cache; preprocessors of parallel workers can share
+    // one. Opt-in: a lookup costs more than the in-place stemmer itself
+    // (see main bench stemcache), so stemming runs uncached by default.
+    void setStemCache(std::shared_ptr<StemCache> cache) { stem_cache = std::move(cache); }
+    std::shared_ptr<StemCache> getStemCache() const { return stem_cache; }
+    
     // Getters
-    bool isStopWord(const std::string& word) const;
+    bool isStopWord(std::string_view word) const;
     
 private:
     bool remove_stop_words;
     bool use_stemming;
     bool remove_numbers;
     int min_word_length;
-    std::unordered_set<std::string> stop_words;
+    StopWordTable stop_words;
+    std::string token_buffer;      // scratch for the token being normalized
+    std::string stem_buffer;       // scratch for cached stems
+    std::shared_ptr<StemCache> stem_cache;
+    
+    // Lowercase, stop-word filter, stem and validate one raw word.
+    // Returns a view into token_buffer, or an empty view if the word is dropped.
+    std::string_view normalizeToken(std::string_view word);
+    
+    // Replace word by its stem, going through stem_cache when one is set
+    void stemInPlace(std::string& word);
     
-    void initializeStopWords();
     bool isValidWord(const std::string& word) const;
-    bool isNumber(const std::string& word) const;
-    
-    // Porter Stemmer helper functions
-    bool isConsonant(const std::string& word, int i) const;
-    int measureWord(const std::string& word) const;
-    bool containsVowel(const std::string& word) const;
-    bool endsWithDoubleConsonant(const std::string& word) const;
-    bool endsWithCVC(const std::string& word) const;
-    std::string step1a(std::string word) const;
-    std::string step1b(std::string word) const;
-    std::string step1c(std::string word) const;
-    std::string step2(std::string word) const;
-    std::string step3(std::string word) const;
-    std::string step4(std::string word) const;
-    std::string step5a(std::string word) const;
-    std::string step5b(std::string word) const;
-};
\ No newline at end of file
+    bool isValidToken(std::string_view word) const;
+    bool isNumber(std::string_view word) const;
+};
+
+template <typename Sink>
+void TextPreprocessor::forEachToken(std::string_view text, Sink&& sink) {
+    // Word boundaries come from the vectorized classifier, 64 bytes at a time
+    CharClass::for_each_word(text.data(), text.size(), [&](const char* word, size_t length) {
+        std::string_view token = normalizeToken(std::string_view(word, length));
+        if (!token.empty()) {
+            sink(token);
+        }
+    });
+}
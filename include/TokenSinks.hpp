@@ -0,0 +1,69 @@
+#pragma once
+#include "LexiconBuilder.hpp"
+#include "ForwardIndex.hpp"
+#include "ConcurrentLexicon.hpp"
+#include "TermTable.hpp"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Sinks for TextPreprocessor::forEachToken. Tokens arrive as string_views
+// and are resolved straight to word ids, so none becomes a heap string.
+
+// Adds every token to the lexicon (collection frequency only)
+class LexiconSink {
+public:
+    explicit LexiconSink(LexiconBuilder& lexicon) : lexicon(lexicon) {}
+    void operator()(std::string_view token) { lexicon.add_word(token, 1); }
+    
+private:
+    LexiconBuilder& lexicon;
+};
+
+// Resolves tokens to word ids and counts per-document term frequencies.
+// Counts live in a dense table indexed by word id that is reused for every
+// document, so the steady state performs no allocation per token.
+class DocumentTermSink {
+public:
+    // grow_lexicon = false only counts words already in the lexicon
+    explicit DocumentTermSink(LexiconBuilder& lexicon, bool grow_lexicon = true);
+    
+    void operator()(std::string_view token);
+    
+    // Write the current document's postings (sorted by word_id) into terms,
+    // return its length in tokens and reset for the next document
+    uint32_t take_document(std::vector<TermPosting>& terms);
+    
+private:
+    LexiconBuilder& lexicon;
+    bool grow_lexicon;
+    std::vector<uint32_t> counts;    // word_id -> frequency in current document
+    std::vector<uint32_t> touched;   // word ids seen in current document
+    uint32_t doc_length;
+};
+
+// DocumentTermSink for one of several parallel tokenizer threads.
+// Tokens resolve to provisional ids of a shared ConcurrentLexicon. Each
+// sink caches the words it has already resolved, so the shared shards
+// are only locked on the first sight of a word by this thread.
+// Documents must be fed in increasing doc_seq order.
+class ConcurrentTermSink {
+public:
+    explicit ConcurrentTermSink(ConcurrentLexicon& lexicon);
+    
+    void begin_document(uint64_t doc_seq);
+    void operator()(std::string_view token);
+    
+    // Like DocumentTermSink::take_document, but the postings carry
+    // provisional word ids and are in no particular order
+    uint32_t take_document(std::vector<TermPosting>& terms);
+    
+private:
+    ConcurrentLexicon& lexicon;
+    TermTable seen;                  // words this thread already resolved
+    std::vector<uint32_t> seen_ids;  // seen index -> provisional id
+    std::vector<uint32_t> counts;    // provisional id -> frequency in current document
+    std::vector<uint32_t> touched;   // provisional ids seen in current document
+    uint64_t doc_seq;
+    uint32_t doc_length;
+};
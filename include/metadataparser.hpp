@@ -1,6 +1,13 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include "FullTextCatalog.hpp"
 
 struct Paper {
     std::string paper_id;      // SHA or PMC ID
@@ -16,34 +23,103 @@ class MetadataParser
 public:
     const std::string data_path;
     std::vector<Paper> papers;
+    unsigned num_threads;      // Worker threads used for full-text extraction
+    FullTextCatalog catalog;   // pdf_json / pmc_json listing, built on first use
+    std::once_flag catalog_once;
     
-    // CSV parsing helpers
-    static void parse_csv_line(const std::string& line, 
-                               std::vector<std::string>& parsed_line);
-    static std::string clean_field(const std::string& field);
+    // Full-text JSON directories
+    std::string pdf_json_dir() const;
+    std::string pmc_json_dir() const;
+    
+    // Scan the full-text directories once (thread-safe)
+    void ensure_catalog();
     
     // Full-text extraction from JSON files
     std::string find_fulltext_pdf(const std::string& sha);
     std::string find_fulltext_xml(const std::string& pmcid);
     
-    // Extract body text from JSON
+    // PDF JSON first (by sha), then PMC JSON (by pmcid)
+    std::string find_fulltext(const std::string& sha, const std::string& pmcid);
+    
+    // Same lookup, returned as a view into the calling thread's scratch buffer
+    // (valid until the next extraction on this thread)
+    std::string_view find_fulltext_view(const std::string& sha, const std::string& pmcid);
+    
+    // PDF JSON first, then PMC JSON, for already resolved files
+    static std::string_view extract_fulltext_view(const FullTextFiles& files);
+    
+    // Fill body_text for one batch of papers on the calling thread plus the
+    // worker pool; returns how many papers received full text
+    int extract_fulltext_batch(std::vector<Paper>& batch,
+                               const std::vector<FullTextFiles>& sources);
+    
+    // Extract body text (abstract + body_text sections) from JSON via a
+    // streaming SAX pass; bib/ref entries and metadata are never materialized
     static std::string extract_body_from_json(const std::string& json_path);
     
+    // Same as above but appends into body_text; returns false on read/parse error.
+    // The file is memory-mapped (pread fallback) and parsed in place.
+    static bool append_body_from_json(const std::string& json_path, std::string& body_text);
+    
+    // Extracts into a reusable per-thread buffer and returns a view of it
+    // (valid until the next extraction on this thread)
+    static std::string_view extract_body_view(const std::string& json_path);
+    
+    // Reference implementation that builds the full nlohmann::json DOM
+    static std::string extract_body_from_json_dom(const std::string& json_path);
+    
     // Extract and save body text to file (optional)
     static void extract_body_text_tofile(const std::string& file_path,
                                         std::ofstream& output_file); 
 
 public:
-    explicit MetadataParser(const std::string& data_path) 
-        : data_path(data_path) {}
+    explicit MetadataParser(const std::string& data_path);
+    ~MetadataParser();
+    
+    // Number of full-text extraction threads (0 = hardware concurrency).
+    // The pool is resized before the next batch.
+    void set_num_threads(unsigned threads);
+    unsigned get_num_threads() const { return num_threads; }
     
     // Get paper count from metadata.csv
     int metadata_stats();
     
-    // Main parsing function - extracts metadata + full body text
+    // Main parsing function - extracts metadata + full body text into papers.
+    // Full-text extraction runs on num_threads workers; papers keep metadata.csv order.
     int metadata_parse();
     
+    // Streaming alternative to metadata_parse: hands each paper to visitor in
+    // metadata.csv order without storing it. At most batch_size papers are in
+    // memory at once; the visitor may move out of the paper. max_docs = 0 means
+    // no limit. Returns the number of papers visited.
+    int for_each_paper(const std::function<void(Paper&)>& visitor,
+                       size_t batch_size = 256, size_t max_docs = 0);
+    
+    // Same stream, one whole batch at a time (for consumers that process
+    // a batch in parallel). Returns the number of papers visited.
+    int for_each_batch(const std::function<void(std::vector<Paper>&)>& visitor,
+                       size_t batch_size = 256, size_t max_docs = 0);
+    
     // Get parsed papers
     const std::vector<Paper>& getPapers() const { return papers; }
     size_t getCount() const { return papers.size(); }
+    
+private:
+    // Persistent extraction pool: num_threads - 1 threads, started by the
+    // first batch and reused by every later one. The calling thread is
+    // worker 0. Each batch bumps pool_generation to wake the pool and waits
+    // until pool_busy drops back to 0.
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable pool_wake;
+    std::condition_variable pool_done;
+    const std::function<void()>* pool_job = nullptr;
+    uint64_t pool_generation = 0;
+    size_t pool_busy = 0;
+    bool pool_stop = false;
+    
+    // Run job on the calling thread and every pool thread; returns when all are done
+    void run_on_pool(const std::function<void()>& job);
+    void pool_loop(uint64_t generation);
+    void stop_pool();
 };
\ No newline at end of file
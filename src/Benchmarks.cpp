@@ -0,0 +1,1262 @@
+#include "../include/Benchmarks.hpp"
+#include "../include/metadataparser.hpp"
+#include "../include/TextPreProcessor.hpp"
+#include "../include/CharClass.hpp"
+#include "../include/StopWordTable.hpp"
+#include "../include/PorterStemmer.hpp"
+#include "../include/LexiconBuilder.hpp"
+#include "../include/MappedLexicon.hpp"
+#include "../include/FstLexicon.hpp"
+#include "../include/ForwardIndex.hpp"
+#include "../include/TokenSinks.hpp"
+#include "../include/DocumentStore.hpp"
+#include "../include/MappedForwardIndex.hpp"
+#include "../include/InvertedIndex.hpp"
+#include "../include/IndexBuilder.hpp"
+#include <random>
+#include <cctype>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+#include <thread>
+#include <memory>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Collect all *.json files below a directory in a stable order
+std::vector<std::string> list_json_files(const std::string& dir) {
+    std::vector<std::string> files;
+    if (!fs::is_directory(dir)) {
+        std::cerr << "Error: " << dir << " is not a directory" << std::endl;
+        return files;
+    }
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+uint64_t total_file_bytes(const std::vector<std::string>& files) {
+    uint64_t bytes = 0;
+    for (const auto& f : files) {
+        bytes += fs::file_size(f);
+    }
+    return bytes;
+}
+
+// Best-of-N wall time in seconds
+double time_best_of(int runs, const std::function<void()>& fn) {
+    double best = 1e300;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, seconds);
+    }
+    return best;
+}
+
+// Drop path from the OS page cache; false where that is unsupported
+// (mingw-w64 has neither fdatasync nor posix_fadvise)
+bool evict_from_page_cache(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    fdatasync(fd);
+    int rc = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    return rc == 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Best-of-N wall time with path evicted from the page cache before each
+// run; negative if the platform cannot evict it
+double time_cold(int runs, const std::string& path, const std::function<void()>& fn) {
+    double best = 1e300;
+    for (int r = 0; r < runs; r++) {
+        if (!evict_from_page_cache(path)) return -1.0;
+        best = std::min(best, time_best_of(1, fn));
+    }
+    return best;
+}
+
+void print_rate(const std::string& label, double seconds, uint64_t bytes, size_t items,
+                const std::string& item_name) {
+    std::cout << "  " << std::left << std::setw(22) << label << std::right
+              << std::fixed << std::setprecision(2)
+              << seconds * 1000.0 << " ms, "
+              << (seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0) << " MB/s, "
+              << std::setprecision(0)
+              << (seconds > 0 ? items / seconds : 0.0) << " " << item_name << "/sec" << std::endl;
+}
+
+// Body text of every paper under json_dir (the tokenizer benchmarks' corpus)
+std::vector<std::string> load_bodies(const std::string& json_dir, uint64_t& bytes) {
+    std::vector<std::string> bodies;
+    bytes = 0;
+    for (const auto& f : list_json_files(json_dir)) {
+        bodies.push_back(MetadataParser::extract_body_from_json(f));
+        bytes += bodies.back().size();
+    }
+    return bodies;
+}
+
+// Allocator that tallies live heap bytes, to measure node-based containers
+size_t counted_bytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U> CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(size_t n) {
+        counted_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        counted_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+    template <typename U> bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+// Build the pre-TermTable lexicon layout (unordered_map<string, pair>)
+// from tokens and measure its heap bytes, build time and lookup time
+void measure_node_map(const std::vector<std::string>& tokens, int runs, size_t& terms,
+                      size_t& bytes, double& build_seconds, double& lookup_seconds,
+                      uint64_t& id_sum) {
+    using Key = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+    using Value = std::pair<const Key, std::pair<uint32_t, uint32_t>>;
+    struct KeyHash {
+        size_t operator()(const Key& k) const noexcept {
+            return std::hash<std::string_view>{}(std::string_view(k.data(), k.size()));
+        }
+    };
+    using NodeMap = std::unordered_map<Key, std::pair<uint32_t, uint32_t>, KeyHash,
+                                       std::equal_to<Key>, CountingAllocator<Value>>;
+    
+    Key key;
+    auto fill = [&](NodeMap& map) {
+        uint32_t next_id = 0;
+        for (const auto& t : tokens) {
+            key.assign(t.data(), t.size());
+            auto found = map.find(key);
+            if (found != map.end()) found->second.second++;
+            else map.emplace(key, std::make_pair(next_id++, 1u));
+        }
+    };
+    
+    build_seconds = time_best_of(runs, [&]() {
+        size_t before = counted_bytes;
+        NodeMap map;
+        fill(map);
+        bytes = counted_bytes - before;
+        terms = map.size();
+    });
+    
+    NodeMap map;
+    fill(map);
+    lookup_seconds = time_best_of(runs, [&]() {
+        id_sum = 0;
+        for (const auto& t : tokens) {
+            key.assign(t.data(), t.size());
+            id_sum += map.find(key)->second.first;
+        }
+    });
+}
+
+// Porter's own examples plus corpus terms, with the output of the reference
+// implementation; voc.txt / output.txt next to the corpus are checked too
+struct StemPair {
+    const char* word;
+    const char* stem;
+};
+
+const StemPair PORTER_REFERENCE[] = {
+    {"caresses", "caress"}, {"ponies", "poni"}, {"ties", "ti"},
+    {"caress", "caress"}, {"cats", "cat"}, {"feed", "feed"}, {"agreed", "agre"},
+    {"plastered", "plaster"}, {"bled", "bled"}, {"motoring", "motor"},
+    {"sing", "sing"}, {"conflated", "conflat"}, {"troubled", "troubl"},
+    {"sized", "size"}, {"hopping", "hop"}, {"tanned", "tan"}, {"falling", "fall"},
+    {"hissing", "hiss"}, {"fizzed", "fizz"}, {"failing", "fail"},
+    {"filing", "file"}, {"happy", "happi"}, {"sky", "sky"},
+    {"relational", "relat"}, {"conditional", "condit"}, {"rational", "ration"},
+    {"valenci", "valenc"}, {"hesitanci", "hesit"}, {"digitizer", "digit"},
+    {"conformabli", "conform"}, {"radicalli", "radic"}, {"differentli", "differ"},
+    {"vileli", "vile"}, {"analogousli", "analog"}, {"vietnamization", "vietnam"},
+    {"predication", "predic"}, {"operator", "oper"}, {"feudalism", "feudal"},
+    {"decisiveness", "decis"}, {"hopefulness", "hope"}, {"callousness", "callous"},
+    {"formaliti", "formal"}, {"sensitiviti", "sensit"}, {"sensibiliti", "sensibl"},
+    {"triplicate", "triplic"}, {"formative", "form"}, {"formalize", "formal"},
+    {"electriciti", "electr"}, {"electrical", "electr"}, {"hopeful", "hope"},
+    {"goodness", "good"}, {"revival", "reviv"}, {"allowance", "allow"},
+    {"inference", "infer"}, {"airliner", "airlin"}, {"gyroscopic", "gyroscop"},
+    {"adjustable", "adjust"}, {"defensible", "defens"}, {"irritant", "irrit"},
+    {"replacement", "replac"}, {"adjustment", "adjust"}, {"dependent", "depend"},
+    {"adoption", "adopt"}, {"homologou", "homolog"}, {"communism", "commun"},
+    {"activate", "activ"}, {"angulariti", "angular"}, {"homologous", "homolog"},
+    {"effective", "effect"}, {"bowdlerize", "bowdler"}, {"probate", "probat"},
+    {"rate", "rate"}, {"cease", "ceas"}, {"controll", "control"}, {"roll", "roll"},
+    {"generalizations", "gener"}, {"oscillators", "oscil"},
+    {"connection", "connect"}, {"connecting", "connect"},
+    {"archaeology", "archaeolog"}, {"analogies", "analog"}, {"syzygy", "syzygi"},
+    {"yearly", "yearli"}, {"infections", "infect"}, {"viral", "viral"},
+    {"proteins", "protein"}, {"patients", "patient"}, {"replication", "replic"},
+    {"transmission", "transmiss"}, {"antibodies", "antibodi"},
+    {"respiratory", "respiratori"}, {"coronavirus", "coronaviru"}
+};
+
+// Replicate source's documents (with suffixed cord_uids) into scaled up to
+// roughly the size of the full CORD-19 corpus
+void replicate_documents(const ForwardIndex& source, ForwardIndex& scaled) {
+    const size_t TARGET_DOCS = 60000;
+    std::vector<TermPosting> terms;
+    for (size_t copy = 0; scaled.get_index_size() < TARGET_DOCS; copy++) {
+        source.for_each_document([&](uint32_t, const DocumentIndex& doc, TermList list) {
+            if (scaled.get_index_size() >= TARGET_DOCS) return;
+            terms.clear();
+            for (const auto& term : list) terms.push_back(term);
+            scaled.add_document(doc.doc_id + "#" + std::to_string(copy), terms, doc.doc_length);
+        });
+    }
+}
+
+} // namespace
+
+bool bench_body_extraction(const std::string& json_dir) {
+    std::vector<std::string> files = list_json_files(json_dir);
+    if (files.empty()) return false;
+    
+    uint64_t bytes = total_file_bytes(files);
+    const int RUNS = 5;
+    
+    std::cout << "=== Body Extraction: " << files.size() << " files, "
+              << bytes / 1024 << " KB ===" << std::endl;
+    
+    // Outputs must be identical before timings mean anything
+    size_t mismatches = 0;
+    for (const auto& f : files) {
+        if (MetadataParser::extract_body_from_json(f) != MetadataParser::extract_body_from_json_dom(f)) {
+            std::cerr << "  Mismatch: " << f << std::endl;
+            mismatches++;
+        }
+    }
+    
+    size_t sink = 0;
+    double dom = time_best_of(RUNS, [&]() {
+        for (const auto& f : files) sink += MetadataParser::extract_body_from_json_dom(f).size();
+    });
+    
+    std::string buffer;
+    double sax = time_best_of(RUNS, [&]() {
+        for (const auto& f : files) {
+            buffer.clear();
+            MetadataParser::append_body_from_json(f, buffer);
+            sink += buffer.size();
+        }
+    });
+    
+    print_rate("DOM (nlohmann::json)", dom, bytes, files.size(), "docs");
+    print_rate("SAX (mmap, in place)", sax, bytes, files.size(), "docs");
+    std::cout << "  Speedup: " << std::setprecision(2) << (sax > 0 ? dom / sax : 0.0) << "x"
+              << ", mismatches: " << mismatches << " (checksum " << sink << ")" << std::endl;
+    
+    return mismatches == 0;
+}
+
+bool bench_tokenizer(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    const int RUNS = 3;
+    bool all_equal = true;
+    
+    for (bool stemming : {false, true}) {
+        TextPreprocessor preprocessor;
+        preprocessor.setUseStemming(stemming);
+        
+        std::cout << "=== Tokenizer (stemming " << (stemming ? "on" : "off") << "): "
+                  << bodies.size() << " docs, " << bytes / 1024 << " KB ===" << std::endl;
+        
+        // Equivalence: the fused scanner must emit exactly the same tokens
+        std::vector<std::string_view> views;
+        std::string buffer;
+        size_t token_count = 0;
+        size_t mismatched_docs = 0;
+        for (const auto& body : bodies) {
+            std::vector<std::string> expected = preprocessor.preprocess(body);
+            preprocessor.preprocessInto(body, views, buffer);
+            token_count += expected.size();
+            if (!std::equal(expected.begin(), expected.end(), views.begin(), views.end())) {
+                mismatched_docs++;
+            }
+        }
+        all_equal = all_equal && mismatched_docs == 0;
+        
+        size_t sink = 0;
+        double classic = time_best_of(RUNS, [&]() {
+            for (const auto& body : bodies) sink += preprocessor.preprocess(body).size();
+        });
+        double fused = time_best_of(RUNS, [&]() {
+            for (const auto& body : bodies) {
+                preprocessor.preprocessInto(body, views, buffer);
+                sink += views.size();
+            }
+        });
+        
+        print_rate("preprocess", classic, bytes, token_count, "tokens");
+        print_rate("preprocessInto", fused, bytes, token_count, "tokens");
+        std::cout << "  Speedup: " << std::setprecision(2) << (fused > 0 ? classic / fused : 0.0) << "x"
+                  << ", mismatched docs: " << mismatched_docs << " (checksum " << sink << ")" << std::endl;
+    }
+    
+    return all_equal;
+}
+
+bool bench_char_class(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    std::string corpus;
+    corpus.reserve(bytes);
+    for (const auto& body : bodies) corpus += body;
+    std::string lowered(corpus.size(), '\0');
+    
+    const int RUNS = 10;
+    auto gbps = [&](double seconds) { return seconds > 0 ? corpus.size() / seconds / 1e9 : 0.0; };
+    
+    std::cout << "=== Char Classification: " << corpus.size() / 1024 << " KB corpus ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    
+    // Locale-aware per-byte reference (what toLowerCase/removeSpecialChars used)
+    size_t ref_words = 0;
+    double ref_lower = time_best_of(RUNS, [&]() {
+        for (size_t i = 0; i < corpus.size(); i++) {
+            lowered[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(corpus[i])));
+        }
+    });
+    std::string reference = lowered;
+    double ref_split = time_best_of(RUNS, [&]() {
+        ref_words = 0;
+        bool in_word = false;
+        for (char c : corpus) {
+            bool word = std::isalnum(static_cast<unsigned char>(c)) != 0;
+            if (word && !in_word) ref_words++;
+            in_word = word;
+        }
+    });
+    std::cout << "  std::tolower/isalnum  lower " << gbps(ref_lower) << " GB/s, split "
+              << gbps(ref_split) << " GB/s (" << ref_words << " words)" << std::endl;
+    
+    bool all_equal = true;
+    CharClass::Kernel original = CharClass::get_kernel();
+    
+    for (CharClass::Kernel kernel : {CharClass::SCALAR, CharClass::SSE2, CharClass::AVX2}) {
+        if (!CharClass::set_kernel(kernel)) {
+            std::cout << "  " << CharClass::kernel_name(kernel) << ": not supported on this CPU" << std::endl;
+            continue;
+        }
+        
+        double lower = time_best_of(RUNS, [&]() {
+            CharClass::to_lower(corpus.data(), &lowered[0], corpus.size());
+        });
+        bool lower_ok = (lowered == reference);
+        
+        size_t words = 0;
+        double split = time_best_of(RUNS, [&]() {
+            words = 0;
+            CharClass::for_each_word(corpus.data(), corpus.size(),
+                                     [&](const char*, size_t) { words++; });
+        });
+        
+        all_equal = all_equal && lower_ok && words == ref_words;
+        std::cout << "  " << std::left << std::setw(20) << CharClass::kernel_name(kernel) << std::right
+                  << "  lower " << gbps(lower) << " GB/s, split " << gbps(split) << " GB/s ("
+                  << words << " words)" << (lower_ok && words == ref_words ? "" : "  MISMATCH")
+                  << std::endl;
+    }
+    
+    CharClass::set_kernel(original);
+    std::cout << "  Active kernel: " << CharClass::kernel_name(original) << std::endl;
+    return all_equal;
+}
+
+bool bench_stop_words(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    // Lowercased words exactly as the tokenizer probes them
+    std::vector<std::string> words;
+    std::string lowered;
+    for (const auto& body : bodies) {
+        lowered.resize(body.size());
+        CharClass::to_lower(body.data(), &lowered[0], body.size());
+        CharClass::for_each_word(lowered.data(), lowered.size(), [&](const char* w, size_t n) {
+            words.emplace_back(w, n);
+        });
+    }
+    
+    StopWordTable table;
+    std::unordered_set<std::string> reference;
+    size_t max_length = 0;
+    for (std::string_view w : table.get_words()) {
+        reference.insert(std::string(w));
+        max_length = std::max(max_length, w.size());
+    }
+    
+    const int RUNS = 10;
+    std::cout << "=== Stop Word Lookup: " << words.size() << " words, "
+              << table.size() << " stop words ===" << std::endl;
+    
+    // Old TextPreprocessor::isStopWord: length cut-off + std::string key
+    size_t set_hits = 0;
+    double set_time = time_best_of(RUNS, [&]() {
+        set_hits = 0;
+        for (const auto& w : words) {
+            std::string_view word(w);
+            if (word.length() > max_length) continue;
+            if (reference.find(std::string(word)) != reference.end()) set_hits++;
+        }
+    });
+    
+    size_t table_hits = 0;
+    double table_time = time_best_of(RUNS, [&]() {
+        table_hits = 0;
+        for (const auto& w : words) {
+            if (table.contains(w)) table_hits++;
+        }
+    });
+    
+    print_rate("unordered_set", set_time, bytes, words.size(), "lookups");
+    print_rate("StopWordTable", table_time, bytes, words.size(), "lookups");
+    std::cout << "  Hits: " << set_hits << " vs " << table_hits
+              << (set_hits == table_hits ? "" : "  MISMATCH") << std::endl;
+    if (table_time > 0) {
+        std::cout << "  Speedup: " << std::setprecision(2) << set_time / table_time << "x" << std::endl;
+    }
+    return set_hits == table_hits;
+}
+
+bool bench_stem_cache(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    const int RUNS = 3;
+    
+    // Reference: stemming without a cache (the default)
+    TextPreprocessor uncached;
+    uncached.setUseStemming(true);
+    
+    std::vector<std::vector<std::string>> expected;
+    size_t token_count = 0;
+    for (const auto& body : bodies) {
+        expected.push_back(uncached.preprocess(body));
+        token_count += expected.back().size();
+    }
+    
+    std::cout << "=== Stem Cache: " << bodies.size() << " docs, " << token_count
+              << " tokens ===" << std::endl;
+    
+    std::vector<std::string_view> views;
+    std::string buffer;
+    size_t sink = 0;
+    double plain = time_best_of(RUNS, [&]() {
+        for (const auto& body : bodies) {
+            uncached.preprocessInto(body, views, buffer);
+            sink += views.size();
+        }
+    });
+    
+    // Cold: a fresh cache every run, so the timing includes warm-up misses
+    TextPreprocessor cached;
+    cached.setUseStemming(true);
+    size_t mismatched_docs = 0;
+    double cold = time_best_of(RUNS, [&]() {
+        cached.setStemCache(std::make_shared<StemCache>());
+        mismatched_docs = 0;
+        for (size_t d = 0; d < bodies.size(); d++) {
+            cached.preprocessInto(bodies[d], views, buffer);
+            if (!std::equal(expected[d].begin(), expected[d].end(), views.begin(), views.end())) {
+                mismatched_docs++;
+            }
+        }
+    });
+    std::shared_ptr<StemCache> cache = cached.getStemCache();
+    double hit_rate = cache->get_hit_rate();
+    size_t vocabulary = cache->get_size();
+    double warm = time_best_of(RUNS, [&]() {
+        for (const auto& body : bodies) {
+            cached.preprocessInto(body, views, buffer);
+            sink += views.size();
+        }
+    });
+    
+    print_rate("uncached", plain, bytes, token_count, "tokens");
+    print_rate("cache (cold)", cold, bytes, token_count, "tokens");
+    print_rate("cache (warm)", warm, bytes, token_count, "tokens");
+    std::cout << "  Cold hit rate: " << std::setprecision(2) << 100.0 * hit_rate << "%, "
+              << vocabulary << " distinct forms, mismatched docs: " << mismatched_docs
+              << " (checksum " << sink << ")" << std::endl;
+    
+    // Several workers sharing one cache must still stem identically
+    const size_t THREADS = 4;
+    auto shared = std::make_shared<StemCache>();
+    std::vector<size_t> thread_mismatches(THREADS, 0);
+    double threaded = time_best_of(1, [&]() {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < THREADS; t++) {
+            workers.emplace_back([&, t]() {
+                TextPreprocessor worker;
+                worker.setUseStemming(true);
+                worker.setStemCache(shared);
+                std::vector<std::string_view> tokens;
+                std::string scratch;
+                for (size_t d = t; d < bodies.size(); d += THREADS) {
+                    worker.preprocessInto(bodies[d], tokens, scratch);
+                    if (!std::equal(expected[d].begin(), expected[d].end(), tokens.begin(), tokens.end())) {
+                        thread_mismatches[t]++;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    });
+    size_t threaded_mismatches = 0;
+    for (size_t m : thread_mismatches) threaded_mismatches += m;
+    print_rate(std::to_string(THREADS) + " threads, shared", threaded, bytes, token_count, "tokens");
+    std::cout << "  Shared cache hit rate: " << std::setprecision(2) << 100.0 * shared->get_hit_rate()
+              << "%, mismatched docs: " << threaded_mismatches << std::endl;
+    
+    return mismatched_docs == 0 && threaded_mismatches == 0;
+}
+
+bool bench_porter_stemmer(const std::string& path) {
+    std::cout << "=== Porter Stemmer ===" << std::endl;
+    
+    // Conformance: built-in reference sample
+    size_t checked = 0;
+    size_t failures = 0;
+    auto check = [&](const std::string& word, const std::string& expected) {
+        std::string stem = PorterStemmer::stem_copy(word);
+        checked++;
+        if (stem != expected) {
+            if (++failures <= 10) {
+                std::cout << "  MISMATCH " << word << ": " << stem << " (expected " << expected << ")" << std::endl;
+            }
+        }
+    };
+    for (const StemPair& pair : PORTER_REFERENCE) {
+        check(pair.word, pair.stem);
+    }
+    std::cout << "  Reference sample: " << checked << " words, " << failures << " mismatches" << std::endl;
+    
+    // Full reference vocabulary, if present: path/voc.txt -> path/output.txt
+    std::ifstream voc(path + "/voc.txt");
+    std::ifstream output(path + "/output.txt");
+    if (voc.is_open() && output.is_open()) {
+        size_t before = checked;
+        std::string word, expected;
+        while (std::getline(voc, word) && std::getline(output, expected)) {
+            check(word, expected);
+        }
+        std::cout << "  voc.txt: " << checked - before << " words, " << failures << " mismatches total" << std::endl;
+    }
+    
+    // Throughput on the corpus tokens (stop words removed, not stemmed)
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(path, bytes);
+    if (!bodies.empty()) {
+        TextPreprocessor preprocessor;
+        std::vector<std::string> words;
+        std::vector<std::string_view> views;
+        std::string buffer;
+        uint64_t word_bytes = 0;
+        for (const auto& body : bodies) {
+            preprocessor.preprocessInto(body, views, buffer);
+            for (std::string_view v : views) {
+                words.emplace_back(v);
+                word_bytes += v.size();
+            }
+        }
+        
+        const int RUNS = 5;
+        size_t sink = 0;
+        double copying = time_best_of(RUNS, [&]() {
+            for (const auto& w : words) sink += preprocessor.stemWord(w).size();
+        });
+        std::string scratch;
+        double in_place = time_best_of(RUNS, [&]() {
+            for (const auto& w : words) {
+                scratch.assign(w);
+                sink += PorterStemmer::stem(&scratch[0], scratch.size());
+            }
+        });
+        print_rate("stemWord (copy)", copying, word_bytes, words.size(), "words");
+        print_rate("in place", in_place, word_bytes, words.size(), "words");
+        std::cout << "  (checksum " << sink << ")" << std::endl;
+    }
+    
+    return failures == 0;
+}
+
+bool bench_lexicon(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    // Token stream exactly as the indexer feeds it to the lexicon
+    TextPreprocessor preprocessor;
+    std::vector<std::string> tokens;
+    std::vector<std::string_view> views;
+    std::string buffer;
+    for (const auto& body : bodies) {
+        preprocessor.preprocessInto(body, views, buffer);
+        for (std::string_view v : views) tokens.emplace_back(v);
+    }
+    
+    // The previous layout: one node + one string per term
+    size_t map_terms = 0;
+    size_t map_bytes = 0;
+    uint64_t map_sum = 0;
+    double map_build = 0;
+    double map_lookup = 0;
+    measure_node_map(tokens, 5, map_terms, map_bytes, map_build, map_lookup, map_sum);
+    
+    const int RUNS = 5;
+    size_t table_bytes = 0;
+    double table_build = time_best_of(RUNS, [&]() {
+        LexiconBuilder lexicon;
+        for (const auto& t : tokens) lexicon.add_word(t, 1);
+        table_bytes = lexicon.get_memory_bytes();
+    });
+    LexiconBuilder lexicon;
+    for (const auto& t : tokens) lexicon.add_word(t, 1);
+    uint64_t table_sum = 0;
+    double table_lookup = time_best_of(RUNS, [&]() {
+        table_sum = 0;
+        for (const auto& t : tokens) table_sum += lexicon.get_word_id(t);
+    });
+    
+    std::cout << "=== Lexicon: " << tokens.size() << " tokens, " << lexicon.get_size()
+              << " terms ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  unordered_map  " << static_cast<double>(map_bytes) / map_terms << " bytes/term, build "
+              << map_build * 1000.0 << " ms, " << std::setprecision(0) << tokens.size() / map_lookup
+              << " lookups/sec" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  TermTable      " << static_cast<double>(table_bytes) / lexicon.get_size()
+              << " bytes/term, build " << table_build * 1000.0 << " ms, " << std::setprecision(0)
+              << tokens.size() / table_lookup << " lookups/sec" << std::endl;
+    
+    bool same = map_terms == lexicon.get_size() && map_sum == table_sum;
+    std::cout << "  Word ids " << (same ? "match" : "MISMATCH") << std::endl;
+    return same;
+}
+
+bool bench_parallel_build(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.size() < 2) return false;
+    
+    // Every eighth paper is followed by a row repeating an earlier cord_uid
+    // with different text: a later paper's body plus a word nothing else
+    // contains. Neither may reach the lexicon on any thread count.
+    const size_t BATCH = 64;
+    std::vector<std::vector<Paper>> batches;
+    size_t duplicates = 0;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (i % BATCH == 0) batches.emplace_back();
+        Paper paper;
+        paper.paper_id = "uid" + std::to_string(i);
+        paper.body_text = bodies[i];
+        batches.back().push_back(paper);
+        if (i % 8 == 7) {
+            // Alternately a cord_uid from this batch and one from an earlier batch
+            paper.paper_id = "uid" + std::to_string(duplicates % 2 == 0 ? i - 3 : i / 2);
+            paper.body_text = bodies[(i + 5) % bodies.size()] + " quasiduplicat";
+            batches.back().push_back(paper);
+            duplicates++;
+        }
+    }
+    
+    const unsigned THREADS = 4;
+    const int RUNS = 3;
+    std::unique_ptr<IndexBuilder> serial, parallel;
+    auto build = [&](unsigned threads, std::unique_ptr<IndexBuilder>& builder) {
+        builder = std::make_unique<IndexBuilder>();
+        builder->set_num_threads(threads);
+        for (const auto& batch : batches) builder->add_papers(batch);
+    };
+    double serial_time = time_best_of(RUNS, [&]() { build(1, serial); });
+    double parallel_time = time_best_of(RUNS, [&]() { build(THREADS, parallel); });
+    
+    // Word ids, words, frequencies and every document's postings must agree
+    LexiconBuilder& serial_lex = serial->get_lexicon();
+    LexiconBuilder& parallel_lex = parallel->get_lexicon();
+    ReverseLexicon serial_words = serial_lex.build_reverse_lexicon();
+    ReverseLexicon parallel_words = parallel_lex.build_reverse_lexicon();
+    bool same = serial_words.size() == parallel_words.size() &&
+                !serial_lex.contains("quasiduplicat") && !parallel_lex.contains("quasiduplicat");
+    for (uint32_t id = 0; same && id < serial_words.size(); id++) {
+        std::string_view word = serial_words.get_word(id);
+        same = word == parallel_words.get_word(id) &&
+               serial_lex.get_frequency(word) == parallel_lex.get_frequency(word);
+    }
+    const ForwardIndex& serial_fwd = serial->get_forward_index();
+    const ForwardIndex& parallel_fwd = parallel->get_forward_index();
+    same = same && serial_fwd.get_index_size() == parallel_fwd.get_index_size() &&
+           serial_fwd.get_total_terms() == parallel_fwd.get_total_terms();
+    for (uint32_t d = 0; same && d < serial_fwd.get_index_size(); d++) {
+        TermList a = serial_fwd.get_document_terms_by_id(d);
+        TermList b = parallel_fwd.get_document_terms_by_id(d);
+        same = serial_fwd.get_documents()[d].doc_id == parallel_fwd.get_documents()[d].doc_id &&
+               a.size() == b.size() &&
+               std::equal(a.word_ids(), a.word_ids() + a.size(), b.word_ids()) &&
+               std::equal(a.frequencies(), a.frequencies() + a.size(), b.frequencies());
+    }
+    
+    std::cout << "=== Parallel Build: " << bodies.size() << " papers + " << duplicates
+              << " duplicate cord_uids, batches of " << BATCH << " ===" << std::endl;
+    print_rate("1 thread", serial_time, bytes, serial_fwd.get_index_size(), "docs");
+    print_rate(std::to_string(THREADS) + " threads", parallel_time, bytes,
+               parallel_fwd.get_index_size(), "docs");
+    std::cout << "  " << serial_words.size() << " terms, " << serial_fwd.get_index_size()
+              << " documents: lexicon and forward index "
+              << (same ? "identical" : "DIFFER") << std::endl;
+    return same;
+}
+
+bool bench_lexicon_load(const std::string& indices_dir) {
+    std::string csv_path = indices_dir + "/lexicon.csv";
+    std::string bin_path = indices_dir + "/lexicon.bin";
+    
+    const int RUNS = 5;
+    LexiconBuilder from_csv;
+    double csv_load = time_best_of(RUNS, [&]() { from_csv.load_from_csv(csv_path); });
+    if (from_csv.get_size() == 0) return false;
+    
+    LexiconBuilder from_bin;
+    double bin_load = time_best_of(RUNS, [&]() { from_bin.load_from_binary(bin_path); });
+    
+    MappedLexicon mapped;
+    double map_open = time_best_of(RUNS, [&]() { mapped.open(bin_path); });
+    if (!mapped.is_open()) return false;
+    
+    // Every word must round-trip with the same id and frequency
+    ReverseLexicon words = from_csv.build_reverse_lexicon();
+    size_t mismatches = 0;
+    std::vector<std::string> queries;
+    std::vector<uint32_t> ids;
+    for (uint32_t word_id = 0; word_id < words.size(); word_id++) {
+        std::string_view word = words.get_word(word_id);
+        if (word.empty()) continue;
+        if (mapped.get_word_id(word) != word_id || mapped.get_word(word_id) != word ||
+            mapped.get_frequency(word) != from_csv.get_frequency(word) ||
+            from_bin.get_word_id(word) != word_id) {
+            mismatches++;
+        }
+        // df / max tf / posting bytes survive load_from_binary
+        const TermStats* stats = from_bin.get_term_stats(word_id);
+        TermStats mapped_stats = mapped.get_term_stats(word_id);
+        if ((stats ? stats->document_frequency : 0) != mapped_stats.document_frequency ||
+            (stats && (stats->max_term_frequency != mapped_stats.max_term_frequency ||
+                       stats->posting_bytes != mapped_stats.posting_bytes))) {
+            mismatches++;
+        }
+        queries.emplace_back(word);
+        ids.push_back(word_id);
+    }
+    mismatches += (mapped.get_size() != ids.size()) + (from_bin.get_size() != ids.size());
+
+    uint64_t sink = 0;
+    double hash_lookup = time_best_of(RUNS, [&]() {
+        for (const auto& q : queries) sink += from_csv.get_word_id(q);
+    });
+    double mapped_lookup = time_best_of(RUNS, [&]() {
+        for (const auto& q : queries) sink += mapped.get_word_id(q);
+    });
+    double mapped_reverse = time_best_of(RUNS, [&]() {
+        for (uint32_t id : ids) sink += mapped.get_word(id).size();
+    });
+    
+    // id->word as the index writers used to get it: a hash map of string copies
+    using Word = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+    using WordMap = std::unordered_map<uint32_t, Word, std::hash<uint32_t>, std::equal_to<uint32_t>,
+                                       CountingAllocator<std::pair<const uint32_t, Word>>>;
+    size_t map_bytes = 0;
+    double map_build = time_best_of(RUNS, [&]() {
+        size_t before = counted_bytes;
+        WordMap map;
+        map.reserve(ids.size());
+        for (size_t i = 0; i < ids.size(); i++) map[ids[i]] = Word(queries[i].data(), queries[i].size());
+        map_bytes = counted_bytes - before;
+    });
+    WordMap map;
+    map.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); i++) map[ids[i]] = Word(queries[i].data(), queries[i].size());
+    double map_reverse = time_best_of(RUNS, [&]() {
+        for (uint32_t id : ids) sink += map.at(id).size();
+    });
+    double dense_build = time_best_of(RUNS, [&]() { words = from_csv.build_reverse_lexicon(); });
+    double dense_reverse = time_best_of(RUNS, [&]() {
+        for (uint32_t id : ids) sink += words.get_word(id).size();
+    });
+    
+    std::cout << "=== Lexicon Load: " << ids.size() << " words ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  load_from_csv         " << csv_load * 1000.0 << " ms" << std::endl;
+    std::cout << "  load_from_binary      " << bin_load * 1000.0 << " ms" << std::endl;
+    std::cout << "  MappedLexicon::open   " << map_open * 1000.0 << " ms" << std::endl;
+    std::cout << std::setprecision(0);
+    std::cout << "  word->id  LexiconBuilder " << queries.size() / hash_lookup << "/sec, MappedLexicon "
+              << queries.size() / mapped_lookup << "/sec" << std::endl;
+    std::cout << "  id->word  MappedLexicon " << ids.size() / mapped_reverse << "/sec, unordered_map "
+              << ids.size() / map_reverse << "/sec, ReverseLexicon " << ids.size() / dense_reverse << "/sec"
+              << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  reverse lexicon  unordered_map " << static_cast<double>(map_bytes) / ids.size()
+              << " bytes/word, built in " << std::setprecision(3) << map_build * 1000.0 << " ms; ReverseLexicon "
+              << std::setprecision(1) << static_cast<double>(words.get_memory_bytes()) / ids.size()
+              << " bytes/word, built in " << std::setprecision(3) << dense_build * 1000.0 << " ms" << std::endl;
+    std::cout << "  Round-trip mismatches: " << mismatches << " (checksum " << sink << ")" << std::endl;
+    return mismatches == 0;
+}
+
+bool bench_fst_lexicon(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    TextPreprocessor preprocessor;
+    LexiconBuilder lexicon;
+    std::vector<std::string> tokens;
+    std::vector<std::string_view> views;
+    std::string buffer;
+    for (const auto& body : bodies) {
+        preprocessor.preprocessInto(body, views, buffer);
+        for (std::string_view v : views) {
+            lexicon.add_word(v, 1);
+            tokens.emplace_back(v);
+        }
+    }
+    
+    ReverseLexicon words = lexicon.build_reverse_lexicon();
+    std::vector<std::pair<std::string_view, uint32_t>> terms;
+    for (uint32_t word_id = 0; word_id < words.size(); word_id++) {
+        if (words.contains(word_id)) terms.emplace_back(words.get_word(word_id), word_id);
+    }
+    
+    const int RUNS = 5;
+    FstLexicon fst;
+    double build = time_best_of(RUNS, [&]() { fst.build(terms); });
+    
+    // Every term maps to its id and enumeration is in byte order
+    size_t mismatches = 0;
+    for (const auto& [word, word_id] : terms) {
+        if (fst.get_word_id(word) != word_id) mismatches++;
+    }
+    std::sort(terms.begin(), terms.end());
+    size_t position = 0;
+    fst.for_each_in_range("", "", [&](std::string_view word, uint32_t word_id) {
+        if (position >= terms.size() || terms[position].first != word || terms[position].second != word_id) {
+            mismatches++;
+        }
+        position++;
+        return true;
+    });
+    mismatches += (position != terms.size());
+    
+    size_t map_terms = 0, map_bytes = 0;
+    uint64_t map_sum = 0;
+    double map_build = 0, map_lookup = 0;
+    measure_node_map(tokens, RUNS, map_terms, map_bytes, map_build, map_lookup, map_sum);
+    
+    uint64_t sink = 0;
+    double fst_lookup = time_best_of(RUNS, [&]() {
+        for (const auto& t : tokens) sink += fst.get_word_id(t);
+    });
+    double prefix_scan = time_best_of(RUNS, [&]() {
+        for (char c = 'a'; c <= 'z'; c++) {
+            fst.for_each_prefix(std::string(1, c), [&](std::string_view, uint32_t id) { sink += id; return true; });
+        }
+    });
+    
+    double term_count = static_cast<double>(terms.size());
+    std::cout << "=== FST Lexicon: " << terms.size() << " terms, " << fst.get_node_count()
+              << " nodes ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  unordered_map  " << map_bytes / term_count << " bytes/term, "
+              << std::setprecision(0) << tokens.size() / map_lookup << " lookups/sec" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "  TermTable      " << lexicon.get_memory_bytes() / term_count << " bytes/term" << std::endl;
+    std::cout << "  FST            " << fst.get_memory_bytes() / term_count << " bytes/term, "
+              << std::setprecision(0) << tokens.size() / fst_lookup << " lookups/sec, built in "
+              << std::setprecision(2) << build * 1000.0 << " ms" << std::endl;
+    std::cout << "  Prefix scans a..z: " << prefix_scan * 1000.0 << " ms ("
+              << std::setprecision(0) << term_count / prefix_scan << " terms/sec)" << std::endl;
+    std::cout << "  Size vs unordered_map: " << std::setprecision(1)
+              << static_cast<double>(map_bytes) / fst.get_memory_bytes() << "x smaller" << std::endl;
+    std::cout << "  Mismatches: " << mismatches << " (checksum " << sink << ")" << std::endl;
+    return mismatches == 0;
+}
+
+bool bench_forward_layout(const std::string& json_dir) {
+    uint64_t bytes = 0;
+    std::vector<std::string> bodies = load_bodies(json_dir, bytes);
+    if (bodies.empty()) return false;
+    
+    // Term lists exactly as the indexer produces them
+    TextPreprocessor preprocessor;
+    LexiconBuilder lexicon;
+    DocumentTermSink sink(lexicon);
+    std::vector<std::vector<TermPosting>> term_lists(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++) {
+        preprocessor.forEachToken(bodies[i], sink);
+        sink.take_document(term_lists[i]);
+    }
+    
+    // Repeat the corpus so the index is well past the caches
+    const size_t COPIES = std::max<size_t>(1, 20000 / bodies.size());
+    
+    // The previous layout: every document owns a vector of postings
+    using Postings = std::vector<TermPosting, CountingAllocator<TermPosting>>;
+    struct VectorDocument {
+        std::string doc_id;
+        std::string title;
+        std::string abstract_text;
+        uint32_t doc_length = 0;
+        Postings terms;
+    };
+    size_t before = counted_bytes;
+    std::vector<VectorDocument> vector_docs;
+    ForwardIndex csr;
+    for (size_t copy = 0; copy < COPIES; copy++) {
+        for (size_t i = 0; i < term_lists.size(); i++) {
+            std::string doc_id = std::to_string(copy) + "/" + std::to_string(i);
+            VectorDocument& doc = vector_docs.emplace_back();
+            doc.doc_id = doc_id;
+            doc.terms.assign(term_lists[i].begin(), term_lists[i].end());
+            csr.add_document(doc_id, term_lists[i], 0);
+        }
+    }
+    size_t vector_bytes = counted_bytes - before + vector_docs.size() * sizeof(Postings);
+    csr.shrink_to_fit();
+    size_t postings = 0;
+    for (const auto& list : term_lists) postings += list.size();
+    postings *= COPIES;
+    
+    // Full scan over every (word_id, frequency), as inversion does
+    const int RUNS = 5;
+    uint64_t vector_sum = 0, csr_sum = 0, column_sum = 0;
+    double vector_scan = time_best_of(RUNS, [&]() {
+        vector_sum = 0;
+        for (const auto& doc : vector_docs) {
+            for (const auto& t : doc.terms) vector_sum += uint64_t(t.word_id) * t.frequency;
+        }
+    });
+    double csr_scan = time_best_of(RUNS, [&]() {
+        csr_sum = 0;
+        for (uint32_t d = 0; d < csr.get_index_size(); d++) {
+            for (const auto& t : csr.get_document_terms_by_id(d)) csr_sum += uint64_t(t.word_id) * t.frequency;
+        }
+    });
+    // One column only (e.g. document frequencies need just the word ids)
+    double column_scan = time_best_of(RUNS, [&]() {
+        column_sum = 0;
+        for (uint32_t d = 0; d < csr.get_index_size(); d++) {
+            TermList terms = csr.get_document_terms_by_id(d);
+            for (size_t i = 0; i < terms.size(); i++) column_sum += terms.word_ids()[i];
+        }
+    });
+    
+    std::cout << "=== Forward Index Layout: " << vector_docs.size() << " documents, "
+              << postings << " postings ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  vector per document  " << vector_bytes / (1024.0 * 1024.0) << " MB ("
+              << vector_docs.size() << " heap blocks), scan " << vector_scan * 1000.0 << " ms ("
+              << std::setprecision(0) << postings / vector_scan << " postings/sec)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "  CSR columns          " << csr.get_term_memory_bytes() / (1024.0 * 1024.0)
+              << " MB (3 heap blocks), scan " << csr_scan * 1000.0 << " ms (" << std::setprecision(0)
+              << postings / csr_scan << " postings/sec)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "  CSR word_id column   scan " << column_scan * 1000.0 << " ms" << std::endl;
+    
+    bool same = vector_sum == csr_sum;
+    std::cout << "  Checksums " << (same ? "match" : "MISMATCH") << " (" << column_sum << ")" << std::endl;
+    return same;
+}
+
+bool bench_document_store(const std::string& indices_dir) {
+    std::string store_path = indices_dir + "/documents.bin";
+    
+    const int RUNS = 5;
+    DocumentStore store;
+    double open_time = time_best_of(RUNS, [&]() { store.open(store_path); });
+    if (!store.is_open() || store.get_size() == 0) return false;
+    
+    // Every document in id order: one decompression per block
+    StoredDocument doc;
+    uint64_t raw_bytes = 0;
+    size_t failures = 0;
+    double sequential = time_best_of(RUNS, [&]() {
+        raw_bytes = 0;
+        for (uint32_t id = 0; id < store.get_size(); id++) {
+            if (!store.get_document(id, doc)) { failures++; continue; }
+            raw_bytes += doc.paper_id.size() + doc.title.size() + doc.authors.size() +
+                         doc.publish_date.size() + doc.abstract_text.size();
+        }
+    });
+    
+    // Result display: scattered ids, usually a block decompression each
+    std::mt19937 rng(42);
+    std::vector<uint32_t> ids(10000);
+    for (auto& id : ids) id = rng() % store.get_size();
+    double random = time_best_of(RUNS, [&]() {
+        for (uint32_t id : ids) failures += !store.get_document(id, doc);
+    });
+    
+    // Term-only runs no longer read any of this
+    ForwardIndex forward;
+    double forward_load = time_best_of(RUNS, [&]() { forward.load_from_binary(indices_dir + "/forward_index.bin"); });
+    
+    std::cout << "=== Document Store: " << store.get_size() << " documents in " << store.get_block_count()
+              << " blocks ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  stored fields " << raw_bytes / 1024.0 << " KB -> documents.bin "
+              << store.get_file_bytes() / 1024.0 << " KB (" << static_cast<double>(raw_bytes) / store.get_file_bytes()
+              << "x)" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "  open " << open_time * 1000.0 << " ms, all documents in order " << sequential * 1000.0
+              << " ms" << std::endl;
+    std::cout << "  random fetch " << random * 1e6 / ids.size() << " us/document" << std::endl;
+    std::cout << "  forward_index.bin (terms only) load " << forward_load * 1000.0 << " ms" << std::endl;
+    std::cout << "  Failed fetches: " << failures << std::endl;
+    return failures == 0;
+}
+
+bool bench_forward_load(const std::string& indices_dir) {
+    std::string small_path = indices_dir + "/forward_index.bin";
+    ForwardIndex source;
+    if (!source.load_from_binary(small_path) || source.get_index_size() == 0) return false;
+    
+    // Full-corpus scale, so open times are not all page faults of a few hundred KB
+    ForwardIndex scaled;
+    replicate_documents(source, scaled);
+    std::string path = indices_dir + "/forward_index.bench.bin";
+    if (!MappedForwardIndex::write(path, scaled)) return false;
+    
+    // A handful of cord_uids to look up, as a query would after opening
+    std::mt19937 rng(42);
+    std::vector<std::string> queries;
+    for (int i = 0; i < 100; i++) {
+        queries.push_back(scaled.get_documents()[rng() % scaled.get_index_size()].doc_id);
+    }
+    
+    const int RUNS = 5;
+    size_t mismatches = 0;
+    uint64_t sink = 0;
+    ForwardIndex loaded;
+    MappedForwardIndex mapped;
+    auto bulk_load = [&]() { loaded.load_from_binary(path); };
+    auto mapped_open = [&]() { mapped.open(path); };
+    auto mapped_query = [&]() {
+        mapped.open(path);
+        for (const auto& q : queries) {
+            for (const auto& term : mapped.get_document_terms_by_id(mapped.get_internal_id(q))) {
+                sink += term.frequency;
+            }
+        }
+    };
+    
+    // Silence the per-load message of load_from_binary while timing
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    double bulk_cold = time_cold(RUNS, path, bulk_load);
+    double bulk_warm = time_best_of(RUNS, bulk_load);
+    std::cout.rdbuf(saved);
+    double open_cold = time_cold(RUNS, path, mapped_open);
+    double open_warm = time_best_of(RUNS, mapped_open);
+    double query_cold = time_cold(RUNS, path, mapped_query);
+    double query_warm = time_best_of(RUNS, mapped_query);
+    
+    // Both readers must agree with the index that was written, in both columns
+    auto same_terms = [](TermList expected, TermList actual) {
+        return actual.size() == expected.size() &&
+               std::equal(expected.word_ids(), expected.word_ids() + expected.size(), actual.word_ids()) &&
+               std::equal(expected.frequencies(), expected.frequencies() + expected.size(), actual.frequencies());
+    };
+    mismatches += loaded.get_index_size() != scaled.get_index_size();
+    mismatches += mapped.get_size() != scaled.get_index_size();
+    for (uint32_t id = 0; id < scaled.get_index_size(); id++) {
+        const DocumentIndex& doc = scaled.get_documents()[id];
+        TermList expected = scaled.get_document_terms_by_id(id);
+        const DocumentIndex* bulk_doc = loaded.get_document_by_id(id);
+        if (mapped.get_internal_id(doc.doc_id) != id || mapped.get_doc_id(id) != doc.doc_id ||
+            mapped.get_document_length(id) != doc.doc_length || loaded.get_internal_id(doc.doc_id) != id ||
+            !bulk_doc || bulk_doc->doc_length != doc.doc_length ||
+            !same_terms(expected, mapped.get_document_terms_by_id(id)) ||
+            !same_terms(expected, loaded.get_document_terms_by_id(id))) {
+            mismatches++;
+        }
+    }
+    size_t file_bytes = fs::file_size(path);
+    mapped.close();
+    fs::remove(path);
+    
+    std::cout << "=== Forward Index Load: " << scaled.get_index_size() << " documents ("
+              << source.get_index_size() << " replicated), " << scaled.get_total_terms() << " terms, "
+              << std::fixed << std::setprecision(1) << file_bytes / (1024.0 * 1024.0) << " MB ===" << std::endl;
+    std::cout << std::setprecision(3);
+    auto row = [](const std::string& label, double cold, double warm) {
+        std::cout << "  " << std::left << std::setw(31) << label << std::right;
+        if (cold < 0) std::cout << std::setw(9) << "n/a" << "    ";
+        else std::cout << std::setw(9) << cold * 1000.0 << " ms ";
+        std::cout << std::setw(9) << warm * 1000.0 << " ms" << std::endl;
+    };
+    std::cout << "                                      cold         warm" << std::endl;
+    row("ForwardIndex::load_from_binary", bulk_cold, bulk_warm);
+    row("MappedForwardIndex::open", open_cold, open_warm);
+    row("open + " + std::to_string(queries.size()) + " cord_uid queries", query_cold, query_warm);
+    if (open_cold < 0) {
+        std::cout << "  (no page cache eviction on this platform: warm runs only)" << std::endl;
+    }
+    std::cout << "  Mismatches: " << mismatches << " (checksum " << sink << ")" << std::endl;
+    return mismatches == 0;
+}
+
+bool bench_index_views(const std::string& indices_dir) {
+    ForwardIndex source;
+    if (!source.load_from_binary(indices_dir + "/forward_index.bin") || source.get_index_size() == 0) {
+        return false;
+    }
+    ForwardIndex forward;
+    replicate_documents(source, forward);
+    
+    // Invert the scaled documents, as IndexBuilder::build_inverted_index does
+    InvertedIndex inverted;
+    std::vector<std::pair<uint32_t, uint32_t>> doc_terms;
+    forward.for_each_document([&](uint32_t id, const DocumentIndex&, TermList terms) {
+        doc_terms.clear();
+        for (const auto& t : terms) doc_terms.emplace_back(t.word_id, t.frequency);
+        inverted.add_document(id, doc_terms);
+    });
+    
+    // Each pair of readers walks the same data and folds it into a checksum:
+    // the old calls copy the container first, the views read it in place
+    const int RUNS = 3;
+    uint64_t copied_sum = 0, viewed_sum = 0;
+    
+    double map_copy = time_best_of(RUNS, [&]() {
+        std::unordered_map<std::string, uint32_t> doc_id_map = forward.get_doc_id_map();
+        copied_sum = 0;
+        for (const auto& [doc_id, id] : doc_id_map) copied_sum += doc_id.size() + id;
+    });
+    double map_view = time_best_of(RUNS, [&]() {
+        viewed_sum = 0;
+        for (const auto& [doc_id, id] : forward.get_doc_id_map()) viewed_sum += doc_id.size() + id;
+    });
+    bool same = copied_sum == viewed_sum;
+    
+    double documents_copy = time_best_of(RUNS, [&]() {
+        std::vector<DocumentIndex> documents = forward.get_documents();
+        copied_sum = 0;
+        for (const auto& doc : documents) copied_sum += doc.doc_length;
+    });
+    double documents_view = time_best_of(RUNS, [&]() {
+        viewed_sum = 0;
+        forward.for_each_document([&](uint32_t, const DocumentIndex& doc, TermList) {
+            viewed_sum += doc.doc_length;
+        });
+    });
+    same = same && copied_sum == viewed_sum;
+    
+    double postings_copy = time_best_of(RUNS, [&]() {
+        auto index = inverted.get_inverted_index();
+        copied_sum = 0;
+        for (const auto& [word_id, postings] : index) {
+            for (const auto& [doc_id, freq] : postings) copied_sum += doc_id ^ (word_id * freq);
+        }
+    });
+    double postings_view = time_best_of(RUNS, [&]() {
+        viewed_sum = 0;
+        inverted.for_each_term([&](uint32_t word_id, PostingList postings) {
+            for (const auto& [doc_id, freq] : postings) viewed_sum += doc_id ^ (word_id * freq);
+        });
+    });
+    same = same && copied_sum == viewed_sum;
+    
+    size_t posting_count = 0;
+    inverted.for_each_term([&](uint32_t, PostingList postings) { posting_count += postings.size(); });
+    
+    std::cout << "=== Index Views: " << forward.get_index_size() << " documents, " << inverted.get_term_count()
+              << " words, " << posting_count << " postings ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "                                 copy + walk      in place" << std::endl;
+    std::cout << "  get_doc_id_map              " << std::setw(11) << map_copy * 1000.0 << " ms "
+              << std::setw(10) << map_view * 1000.0 << " ms" << std::endl;
+    std::cout << "  get_documents / visitor     " << std::setw(11) << documents_copy * 1000.0 << " ms "
+              << std::setw(10) << documents_view * 1000.0 << " ms" << std::endl;
+    std::cout << "  get_inverted_index / visitor" << std::setw(11) << postings_copy * 1000.0 << " ms "
+              << std::setw(10) << postings_view * 1000.0 << " ms" << std::endl;
+    std::cout << "  Checksums " << (same ? "match" : "MISMATCH") << " (" << viewed_sum << ")" << std::endl;
+    return same;
+}
+
+int run_benchmark(const std::string& name, const std::string& path) {
+    if (name == "extract") return bench_body_extraction(path) ? 0 : 1;
+    if (name == "tokenize") return bench_tokenizer(path) ? 0 : 1;
+    if (name == "charclass") return bench_char_class(path) ? 0 : 1;
+    if (name == "stopwords") return bench_stop_words(path) ? 0 : 1;
+    if (name == "stemcache") return bench_stem_cache(path) ? 0 : 1;
+    if (name == "porter") return bench_porter_stemmer(path) ? 0 : 1;
+    if (name == "lexicon") return bench_lexicon(path) ? 0 : 1;
+    if (name == "parallel") return bench_parallel_build(path) ? 0 : 1;
+    if (name == "lexload") return bench_lexicon_load(path) ? 0 : 1;
+    if (name == "fst") return bench_fst_lexicon(path) ? 0 : 1;
+    if (name == "forward") return bench_forward_layout(path) ? 0 : 1;
+    if (name == "docstore") return bench_document_store(path) ? 0 : 1;
+    if (name == "fwdload") return bench_forward_load(path) ? 0 : 1;
+    if (name == "views") return bench_index_views(path) ? 0 : 1;
+    
+    std::cerr << "Usage: main bench <name> <path>\n"
+              << "  extract <json_dir>    DOM vs SAX body extraction\n"
+              << "  tokenize <json_dir>   preprocess vs fused preprocessInto\n"
+              << "  charclass <json_dir>  SIMD case folding / word splitting (GB/s)\n"
+              << "  stopwords <json_dir>  compile-time stop word table vs unordered_set\n"
+              << "  stemcache <json_dir>  stemming with / without the shared stem cache\n"
+              << "  porter <json_dir>     stemmer conformance (+ voc.txt/output.txt) and words/sec\n"
+              << "  lexicon <json_dir>    node-based map vs arena-interned TermTable lexicon\n"
+              << "  parallel <json_dir>   1 vs 4 tokenizer threads, identical output with duplicate cord_uids\n"
+              << "  lexload <indices_dir> lexicon.csv parse vs mapped lexicon.bin open\n"
+              << "  fst <json_dir>        FST lexicon size, lookups and prefix scans\n"
+              << "  forward <json_dir>    per-document vectors vs CSR forward index (memory, scan)\n"
+              << "  docstore <indices_dir> compressed documents.bin size and fetch latency\n"
+              << "  fwdload <indices_dir> forward index bulk load vs mapped open, cold and warm\n"
+              << "  views <indices_dir>   copying index getters vs zero-copy views and visitors\n";
+    return 1;
+}
@@ -0,0 +1,181 @@
+#include "../include/CharClass.hpp"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHARCLASS_X86 1
+#endif
+
+namespace {
+
+// ==================== SCALAR ====================
+
+void to_lower_scalar(const char* src, char* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        dst[i] = static_cast<char>(static_cast<unsigned char>(c - 'A') < 26 ? c | 0x20 : c);
+    }
+}
+
+uint64_t word_mask_scalar(const char* s, size_t n) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (CharClass::is_word_char(s[i])) mask |= 1ULL << i;
+    }
+    return mask;
+}
+
+#ifdef CHARCLASS_X86
+
+// ==================== SSE2 ====================
+// Unsigned "c - lo < len" via signed compares on bytes biased by 0x80
+
+__attribute__((target("sse2")))
+inline __m128i in_range_sse2(__m128i c, char lo, char len) {
+    __m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8(static_cast<char>(lo + 0x80)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(len - 0x80)));
+}
+
+__attribute__((target("sse2")))
+inline uint32_t word_mask16_sse2(const char* s) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i digit = in_range_sse2(c, '0', 10);
+    __m128i alpha = in_range_sse2(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 26);
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(digit, alpha)));
+}
+
+__attribute__((target("sse2")))
+void to_lower_sse2(const char* src, char* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i upper = in_range_sse2(c, 'A', 26);
+        c = _mm_or_si128(c, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), c);
+    }
+    to_lower_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("sse2")))
+uint64_t word_mask_sse2(const char* s, size_t n) {
+    // Zero padding is a separator, so a short tail can use the full-width path
+    alignas(16) char tail[64];
+    if (n < 64) {
+        std::memset(tail, 0, sizeof(tail));
+        std::memcpy(tail, s, n);
+        s = tail;
+    }
+    return word_mask16_sse2(s) | (uint64_t)word_mask16_sse2(s + 16) << 16 |
+           (uint64_t)word_mask16_sse2(s + 32) << 32 | (uint64_t)word_mask16_sse2(s + 48) << 48;
+}
+
+// ==================== AVX2 ====================
+
+__attribute__((target("avx2")))
+inline __m256i in_range_avx2(__m256i c, char lo, char len) {
+    __m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8(static_cast<char>(lo + 0x80)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(len - 0x80)), shifted);
+}
+
+__attribute__((target("avx2")))
+inline uint32_t word_mask32_avx2(const char* s) {
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    __m256i digit = in_range_avx2(c, '0', 10);
+    __m256i alpha = in_range_avx2(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 26);
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)));
+}
+
+__attribute__((target("avx2")))
+void to_lower_avx2(const char* src, char* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i upper = in_range_avx2(c, 'A', 26);
+        c = _mm256_or_si256(c, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), c);
+    }
+    to_lower_scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2")))
+uint64_t word_mask_avx2(const char* s, size_t n) {
+    alignas(32) char tail[64];
+    if (n < 64) {
+        std::memset(tail, 0, sizeof(tail));
+        std::memcpy(tail, s, n);
+        s = tail;
+    }
+    return word_mask32_avx2(s) | (uint64_t)word_mask32_avx2(s + 32) << 32;
+}
+
+#endif // CHARCLASS_X86
+
+// ==================== DISPATCH ====================
+
+struct Kernels {
+    void (*to_lower)(const char*, char*, size_t);
+    uint64_t (*word_mask)(const char*, size_t);
+    CharClass::Kernel kernel;
+};
+
+Kernels kernels_for(CharClass::Kernel kernel) {
+#ifdef CHARCLASS_X86
+    if (kernel == CharClass::AVX2) return {to_lower_avx2, word_mask_avx2, CharClass::AVX2};
+    if (kernel == CharClass::SSE2) return {to_lower_sse2, word_mask_sse2, CharClass::SSE2};
+#endif
+    return {to_lower_scalar, word_mask_scalar, CharClass::SCALAR};
+}
+
+CharClass::Kernel best_kernel() {
+    if (CharClass::is_supported(CharClass::AVX2)) return CharClass::AVX2;
+    if (CharClass::is_supported(CharClass::SSE2)) return CharClass::SSE2;
+    return CharClass::SCALAR;
+}
+
+Kernels& active() {
+    static Kernels kernels = kernels_for(best_kernel());
+    return kernels;
+}
+
+} // namespace
+
+void CharClass::to_lower(const char* src, char* dst, size_t n) {
+    active().to_lower(src, dst, n);
+}
+
+uint64_t CharClass::word_mask(const char* s, size_t n) {
+    return active().word_mask(s, n);
+}
+
+CharClass::Kernel CharClass::get_kernel() {
+    return active().kernel;
+}
+
+bool CharClass::set_kernel(Kernel kernel) {
+    if (!is_supported(kernel)) return false;
+    active() = kernels_for(kernel);
+    return true;
+}
+
+bool CharClass::is_supported(Kernel kernel) {
+    switch (kernel) {
+        case SCALAR:
+            return true;
+#ifdef CHARCLASS_X86
+        case SSE2:
+            return __builtin_cpu_supports("sse2");
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* CharClass::kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case AVX2: return "AVX2";
+        case SSE2: return "SSE2";
+        default:   return "scalar";
+    }
+}
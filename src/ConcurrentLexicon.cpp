@@ -0,0 +1,80 @@
+#include "../include/ConcurrentLexicon.hpp"
+#include <algorithm>
+#include <functional>
+
+ConcurrentLexicon::ConcurrentLexicon(size_t num_shards) : next_provisional_id(0) {
+    // Power-of-two shard count so the shard is a mask of the hash
+    size_t count = 1;
+    while (count < num_shards) count *= 2;
+    for (size_t i = 0; i < count; i++) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+uint32_t ConcurrentLexicon::add_word(std::string_view word, uint64_t first_seen) {
+    size_t h = std::hash<std::string_view>{}(word);
+    Shard& shard = *shards[(h >> 32) & (shards.size() - 1)];
+    
+    std::lock_guard<std::mutex> guard(shard.lock);
+    bool inserted = false;
+    uint32_t index = shard.terms.insert(word, inserted);
+    
+    if (inserted) {
+        uint32_t provisional_id = next_provisional_id.fetch_add(1, std::memory_order_relaxed);
+        shard.provisional_ids.push_back(provisional_id);
+        shard.first_seen.push_back(first_seen);
+        shard.pending.push_back(index);
+        return provisional_id;
+    }
+    
+    if (first_seen < shard.first_seen[index]) {
+        shard.first_seen[index] = first_seen;
+    }
+    return shard.provisional_ids[index];
+}
+
+size_t ConcurrentLexicon::finalize() {
+    struct NewTerm {
+        uint64_t first_seen;
+        Location location;
+    };
+    
+    std::vector<NewTerm> new_terms;
+    for (uint32_t s = 0; s < shards.size(); s++) {
+        Shard& shard = *shards[s];
+        for (uint32_t index : shard.pending) {
+            new_terms.push_back(NewTerm{shard.first_seen[index], Location{s, index}});
+        }
+        shard.pending.clear();
+    }
+    
+    // First-seen keys are unique (one token per position), so the order is total
+    std::sort(new_terms.begin(), new_terms.end(),
+              [](const NewTerm& a, const NewTerm& b) { return a.first_seen < b.first_seen; });
+    
+    final_ids.resize(next_provisional_id.load());
+    for (const NewTerm& term : new_terms) {
+        const Shard& shard = *shards[term.location.shard];
+        final_ids[shard.provisional_ids[term.location.index]] = static_cast<uint32_t>(final_locations.size());
+        final_locations.push_back(term.location);
+    }
+    return new_terms.size();
+}
+
+std::string_view ConcurrentLexicon::get_word(uint32_t final_id) const {
+    const Location& location = final_locations[final_id];
+    return shards[location.shard]->terms.get_term(location.index);
+}
+
+void ConcurrentLexicon::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        shard->terms.clear();
+        shard->provisional_ids.clear();
+        shard->first_seen.clear();
+        shard->pending.clear();
+    }
+    next_provisional_id = 0;
+    final_ids.clear();
+    final_locations.clear();
+}
@@ -0,0 +1,169 @@
+#include "../include/CsvReader.hpp"
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CSV_USE_SSE2 1
+#endif
+
+namespace {
+
+// First ',', '\n' or '\r' in [p, end), or end
+const char* find_delimiter(const char* p, const char* end) {
+#ifdef CSV_USE_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                       _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != ',' && *p != '\n' && *p != '\r') {
+        p++;
+    }
+    return p;
+}
+
+} // namespace
+
+CsvReader::CsvReader() : pos(nullptr), end(nullptr), record_number(0) {}
+
+bool CsvReader::open(const std::string& path, bool has_header) {
+    close();
+    
+    if (!file.open(path)) {
+        std::cerr << "Error: Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    pos = file.data();
+    end = file.data() + file.size();
+    
+    // Skip a UTF-8 byte order mark
+    if (end - pos >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0) {
+        pos += 3;
+    }
+    
+    if (has_header && next_row()) {
+        std::string scratch;
+        for (size_t i = 0; i < fields.size(); i++) {
+            header.emplace_back(field_unescaped(i, scratch));
+            columns.emplace(header.back(), static_cast<int>(i));
+        }
+    }
+    
+    return true;
+}
+
+void CsvReader::close() {
+    file.close();
+    pos = end = nullptr;
+    fields.clear();
+    header.clear();
+    columns.clear();
+    record_number = 0;
+}
+
+bool CsvReader::next_row() {
+    while (pos < end) {
+        // Skip blank lines
+        if (*pos == '\n' || *pos == '\r') {
+            pos++;
+            continue;
+        }
+        parse_record();
+        record_number++;
+        return true;
+    }
+    fields.clear();
+    return false;
+}
+
+void CsvReader::parse_record() {
+    fields.clear();
+    
+    while (true) {
+        FieldSpan span{pos, 0, false};
+        
+        if (pos < end && *pos == '"') {
+            // Quoted field: runs to the next quote not followed by another quote
+            const char* start = ++pos;
+            const char* close = end;   // unterminated: take the rest of the file
+            while (pos < end) {
+                const char* quote = static_cast<const char*>(
+                    std::memchr(pos, '"', static_cast<size_t>(end - pos)));
+                if (!quote) {
+                    pos = end;
+                    break;
+                }
+                if (quote + 1 < end && quote[1] == '"') {
+                    span.has_escapes = true;
+                    pos = quote + 2;
+                    continue;
+                }
+                close = quote;
+                pos = quote + 1;
+                break;
+            }
+            span.begin = start;
+            span.length = static_cast<size_t>(close - start);
+            
+            // Tolerate stray characters between the closing quote and the delimiter
+            pos = find_delimiter(pos, end);
+        } else {
+            const char* delim = find_delimiter(pos, end);
+            span.length = static_cast<size_t>(delim - pos);
+            pos = delim;
+        }
+        
+        fields.push_back(span);
+        
+        if (pos < end && *pos == ',') {
+            pos++;
+            continue;
+        }
+        
+        // End of record: consume \n, \r\n or a lone \r
+        if (pos < end && *pos == '\r') pos++;
+        if (pos < end && *pos == '\n') pos++;
+        return;
+    }
+}
+
+std::string_view CsvReader::field(size_t i) const {
+    if (i >= fields.size()) return std::string_view();
+    return std::string_view(fields[i].begin, fields[i].length);
+}
+
+std::string_view CsvReader::field_unescaped(size_t i, std::string& scratch) const {
+    if (i >= fields.size()) return std::string_view();
+    
+    const FieldSpan& span = fields[i];
+    if (!span.has_escapes) {
+        return std::string_view(span.begin, span.length);
+    }
+    
+    scratch.clear();
+    scratch.reserve(span.length);
+    for (size_t j = 0; j < span.length; j++) {
+        scratch += span.begin[j];
+        if (span.begin[j] == '"' && j + 1 < span.length && span.begin[j + 1] == '"') {
+            j++;
+        }
+    }
+    return scratch;
+}
+
+int CsvReader::column_index(const std::string& name) const {
+    auto it = columns.find(name);
+    return it != columns.end() ? it->second : -1;
+}
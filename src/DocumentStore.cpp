@@ -0,0 +1,351 @@
+#include "../include/DocumentStore.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'D', 'S', 'T', 'R'};
+const uint32_t VERSION = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t document_count;
+    uint32_t block_count;
+    uint64_t table_offset;
+};
+
+struct BlockEntry {
+    uint64_t offset;
+    uint32_t compressed_bytes;
+    uint32_t raw_bytes;
+    uint32_t first_doc;
+    uint32_t reserved;
+};
+
+// ---- LZ77 block coder ----
+// A block is a run of sequences: a token byte (high nibble literal count,
+// low nibble match length - MIN_MATCH; 15 means 255-chained bytes follow),
+// the literals, then a 2-byte match offset and any extra length bytes.
+// The final sequence carries literals only.
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+
+uint32_t load32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void put_length(std::string& out, size_t extra) {
+    while (extra >= 255) {
+        out.push_back(static_cast<char>(255));
+        extra -= 255;
+    }
+    out.push_back(static_cast<char>(extra));
+}
+
+void put_sequence(std::string& out, const char* literals, size_t literal_count,
+                  size_t offset, size_t match_length) {
+    size_t match_code = match_length >= MIN_MATCH ? match_length - MIN_MATCH : 0;
+    unsigned char token = static_cast<unsigned char>((std::min<size_t>(literal_count, 15) << 4) |
+                                                     std::min<size_t>(match_code, 15));
+    out.push_back(static_cast<char>(token));
+    if (literal_count >= 15) put_length(out, literal_count - 15);
+    out.append(literals, literal_count);
+    if (match_length == 0) return;
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) put_length(out, match_code - 15);
+}
+
+void lz_compress(const std::string& src, std::string& out) {
+    out.clear();
+    const char* data = src.data();
+    size_t n = src.size();
+
+    // Last position seen for each hashed 4-byte prefix (+1, 0 = none)
+    uint32_t table[1 << HASH_BITS] = {};
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + MIN_MATCH <= n) {
+        uint32_t sequence = load32(data + i);
+        uint32_t h = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        size_t candidate = table[h];
+        table[h] = static_cast<uint32_t>(i + 1);
+
+        if (candidate == 0 || i - (candidate - 1) > MAX_OFFSET ||
+            load32(data + candidate - 1) != sequence) {
+            i++;
+            continue;
+        }
+        candidate--;
+        size_t length = MIN_MATCH;
+        while (i + length < n && data[candidate + length] == data[i + length]) length++;
+
+        put_sequence(out, data + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    put_sequence(out, data + anchor, n - anchor, 0, 0);
+}
+
+bool read_length(const unsigned char*& ip, const unsigned char* end, size_t& length) {
+    unsigned char b;
+    do {
+        if (ip == end) return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+bool lz_decompress(const char* src, size_t src_size, char* dst, size_t dst_size) {
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + src_size;
+    char* op = dst;
+    char* op_end = dst + dst_size;
+
+    while (ip < end) {
+        unsigned char token = *ip++;
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !read_length(ip, end, literal_count)) return false;
+        if (literal_count > static_cast<size_t>(end - ip) ||
+            literal_count > static_cast<size_t>(op_end - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literal_count);
+        ip += literal_count;
+        op += literal_count;
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(ip, end, match_length)) return false;
+        match_length += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) ||
+            match_length > static_cast<size_t>(op_end - op)) {
+            return false;
+        }
+        // Byte by byte: the match may overlap the bytes it produces
+        const char* match = op - offset;
+        for (size_t k = 0; k < match_length; k++) op[k] = match[k];
+        op += match_length;
+    }
+    return op == op_end;
+}
+
+void put_varint(std::string& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool get_field(const char*& p, const char* end, std::string_view& field) {
+    size_t length = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (p == end || shift > 28) return false;
+        unsigned char b = static_cast<unsigned char>(*p++);
+        length |= static_cast<size_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    if (length > static_cast<size_t>(end - p)) return false;
+    field = std::string_view(p, length);
+    p += length;
+    return true;
+}
+
+} // namespace
+
+// ================= DocumentStoreWriter =================
+
+bool DocumentStoreWriter::open(const std::string& path) {
+    close();
+    out.open(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot open file " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    document_count = block_first_doc = block_count = 0;
+    raw_bytes = compressed_bytes = 0;
+    block.clear();
+    table.clear();
+
+    // The header is rewritten by close() once the counts are known
+    FileHeader header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return true;
+}
+
+void DocumentStoreWriter::add_document(std::string_view paper_id, std::string_view title,
+                                       std::string_view authors, std::string_view publish_date,
+                                       std::string_view abstract_text) {
+    if (!out.is_open()) return;
+
+    for (std::string_view field : {paper_id, title, authors, publish_date, abstract_text}) {
+        put_varint(block, field.size());
+        block.append(field.data(), field.size());
+    }
+    document_count++;
+
+    if (block.size() >= BLOCK_BYTES) {
+        flush_block();
+    }
+}
+
+bool DocumentStoreWriter::flush_block() {
+    if (block.empty()) return true;
+
+    lz_compress(block, compressed);
+
+    BlockEntry entry = {};
+    entry.offset = static_cast<uint64_t>(out.tellp());
+    entry.compressed_bytes = static_cast<uint32_t>(compressed.size());
+    entry.raw_bytes = static_cast<uint32_t>(block.size());
+    entry.first_doc = block_first_doc;
+    out.write(compressed.data(), compressed.size());
+
+    const char* bytes = reinterpret_cast<const char*>(&entry);
+    table.insert(table.end(), bytes, bytes + sizeof(entry));
+
+    raw_bytes += block.size();
+    compressed_bytes += compressed.size();
+    block_count++;
+    block_first_doc = document_count;
+    block.clear();
+    return out.good();
+}
+
+bool DocumentStoreWriter::close() {
+    if (!out.is_open()) return false;
+
+    bool ok = flush_block();
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.document_count = document_count;
+    header.block_count = block_count;
+    header.table_offset = static_cast<uint64_t>(out.tellp());
+    out.write(table.data(), table.size());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ok = ok && out.good();
+    out.close();
+    return ok;
+}
+
+// ================= DocumentStore =================
+
+bool DocumentStore::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: Cannot open document store " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: " << path << " is not a document store" << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Error: " << path << " is not a version " << VERSION << " document store" << std::endl;
+        close();
+        return false;
+    }
+    if (header.table_offset > file.size() ||
+        (file.size() - header.table_offset) / sizeof(BlockEntry) != header.block_count) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+
+    // The block table is small; copy it out of the (unaligned) mapping.
+    // get_document() finds blocks by first_doc, so block 0 must start at
+    // document 0 and every later block strictly after its predecessor.
+    // The coder emits at most 255 bytes per input byte, which bounds
+    // raw_bytes (and so the cache allocation) by the compressed size.
+    blocks.reserve(header.block_count);
+    for (uint32_t i = 0; i < header.block_count; i++) {
+        BlockEntry entry;
+        std::memcpy(&entry, file.data() + header.table_offset + i * sizeof(BlockEntry), sizeof(entry));
+        bool valid = entry.offset <= header.table_offset &&
+                     entry.compressed_bytes <= header.table_offset - entry.offset &&
+                     entry.raw_bytes <= static_cast<uint64_t>(entry.compressed_bytes) * 255 &&
+                     entry.first_doc < header.document_count &&
+                     (i == 0 ? entry.first_doc == 0 : entry.first_doc > blocks.back().first_doc);
+        if (!valid) {
+            std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+            close();
+            return false;
+        }
+        blocks.push_back(Block{entry.offset, entry.compressed_bytes, entry.raw_bytes, entry.first_doc});
+    }
+    if (blocks.empty() && header.document_count != 0) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    document_count = header.document_count;
+    return true;
+}
+
+void DocumentStore::close() {
+    file.close();
+    blocks.clear();
+    document_count = 0;
+    cached_block = -1;
+    cache.clear();
+}
+
+bool DocumentStore::load_block(size_t index) {
+    if (cached_block == static_cast<int>(index)) return true;
+
+    const Block& b = blocks[index];
+    cache.resize(b.raw_bytes);
+    if (!lz_decompress(file.data() + b.offset, b.compressed_bytes, &cache[0], b.raw_bytes)) {
+        std::cerr << "Error: document store block " << index << " is corrupt" << std::endl;
+        cached_block = -1;
+        return false;
+    }
+    cached_block = static_cast<int>(index);
+    return true;
+}
+
+bool DocumentStore::get_document(uint32_t doc_id, StoredDocument& doc) {
+    if (doc_id >= document_count || blocks.empty()) return false;
+
+    // Last block whose first document is <= doc_id
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), doc_id,
+                               [](uint32_t id, const Block& b) { return id < b.first_doc; });
+    size_t index = static_cast<size_t>(it - blocks.begin()) - 1;
+    if (!load_block(index)) return false;
+
+    const char* p = cache.data();
+    const char* end = p + cache.size();
+    std::string_view fields[5];
+    for (uint32_t d = blocks[index].first_doc; d <= doc_id; d++) {
+        for (auto& field : fields) {
+            if (!get_field(p, end, field)) return false;
+        }
+    }
+
+    doc.paper_id.assign(fields[0]);
+    doc.title.assign(fields[1]);
+    doc.authors.assign(fields[2]);
+    doc.publish_date.assign(fields[3]);
+    doc.abstract_text.assign(fields[4]);
+    return true;
+}
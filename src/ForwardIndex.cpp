@@ -1,28 +1,15 @@
 #include "../include/ForwardIndex.hpp"
+#include "../include/MappedForwardIndex.hpp"
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
 
 ForwardIndex::ForwardIndex() 
-    : next_doc_id(0), total_documents(0), total_terms(0) {}
+    : term_offsets(1, 0), total_documents(0), total_terms(0) {}
 
-void ForwardIndex::add_document(const std::string& doc_id,
-                                const std::string& title,
-                                const std::string& abstract_text,
+bool ForwardIndex::add_document(const std::string& doc_id,
                                 const std::vector<uint32_t>& word_ids) {
     
-    // Check if document already exists
-    if (forward_index.find(doc_id) != forward_index.end()) {
-        std::cerr << "Warning: Document " << doc_id << " already exists. Skipping." << std::endl;
-        return;
-    }
-    
-    DocumentIndex doc_index;
-    doc_index.doc_id = doc_id;
-    doc_index.title = title;
-    doc_index.abstract_text = abstract_text;
-    doc_index.doc_length = word_ids.size();
-    
     // Create term frequency map: word_id -> frequency
     std::unordered_map<uint32_t, uint32_t> term_map;
     
@@ -31,187 +18,122 @@ void ForwardIndex::add_document(const std::string& doc_id,
     }
     
     // Convert term_map to vector of TermPosting
-    doc_index.terms.reserve(term_map.size());
+    std::vector<TermPosting> terms;
+    terms.reserve(term_map.size());
     for (const auto& entry : term_map) {
-        TermPosting posting;
-        posting.word_id = entry.first;
-        posting.frequency = entry.second;
-        doc_index.terms.push_back(posting);
+        terms.emplace_back(entry.first, entry.second);
     }
     
     // Sort terms by word_id for efficient lookup
-    std::sort(doc_index.terms.begin(), doc_index.terms.end(),
+    std::sort(terms.begin(), terms.end(),
               [](const TermPosting& a, const TermPosting& b) {
                   return a.word_id < b.word_id;
               });
     
-    // Add to forward index
-    forward_index[doc_id] = doc_index;
-    doc_id_map[doc_id] = next_doc_id++;
+    return add_document(doc_id, terms, word_ids.size());
+}
+
+bool ForwardIndex::add_document(const std::string& doc_id,
+                                const std::vector<TermPosting>& terms,
+                                uint32_t doc_length) {
+    
+    // The next internal id is the document's position in the table
+    uint32_t internal_id = static_cast<uint32_t>(documents.size());
+    if (!doc_id_map.emplace(doc_id, internal_id).second) {
+        std::cerr << "Warning: Document " << doc_id << " already exists. Skipping." << std::endl;
+        return false;
+    }
+    
+    DocumentIndex& doc_index = documents.emplace_back();
+    doc_index.doc_id = doc_id;
+    doc_index.doc_length = doc_length;
+    
+    // Append the term list to the CSR columns
+    for (const auto& term : terms) {
+        term_word_ids.push_back(term.word_id);
+        term_frequencies.push_back(term.frequency);
+    }
+    term_offsets.push_back(static_cast<uint32_t>(term_word_ids.size()));
     
     // Update statistics
     total_documents++;
-    total_terms += word_ids.size();
+    total_terms += doc_length;
+    return true;
 }
 
 const DocumentIndex* ForwardIndex::get_document(const std::string& doc_id) const {
-    auto it = forward_index.find(doc_id);
-    if (it != forward_index.end()) {
-        return &(it->second);
+    auto it = doc_id_map.find(doc_id);
+    if (it != doc_id_map.end()) {
+        return &documents[it->second];
     }
     return nullptr;
 }
 
-const std::vector<TermPosting>* ForwardIndex::get_document_terms(const std::string& doc_id) const {
-    auto it = forward_index.find(doc_id);
-    if (it != forward_index.end()) {
-        return &(it->second.terms);
-    }
-    return nullptr;
+uint32_t ForwardIndex::get_internal_id(const std::string& doc_id) const {
+    auto it = doc_id_map.find(doc_id);
+    return it != doc_id_map.end() ? it->second : UINT32_MAX;
+}
+
+TermList ForwardIndex::get_document_terms(const std::string& doc_id) const {
+    auto it = doc_id_map.find(doc_id);
+    return it != doc_id_map.end() ? get_document_terms_by_id(it->second) : TermList();
 }
 
 uint32_t ForwardIndex::get_document_length(const std::string& doc_id) const {
-    auto it = forward_index.find(doc_id);
-    if (it != forward_index.end()) {
-        return it->second.doc_length;
-    }
-    return 0;
+    const DocumentIndex* doc = get_document(doc_id);
+    return doc ? doc->doc_length : 0;
 }
 
 uint32_t ForwardIndex::get_term_frequency(const std::string& doc_id, uint32_t word_id) const {
-    auto it = forward_index.find(doc_id);
-    if (it == forward_index.end()) {
-        return 0;
-    }
+    TermList terms = get_document_terms(doc_id);
     
     // Binary search since terms are sorted by word_id
-    const auto& terms = it->second.terms;
-    auto term_it = std::lower_bound(terms.begin(), terms.end(), word_id,
-                                     [](const TermPosting& posting, uint32_t id) {
-                                         return posting.word_id < id;
-                                     });
+    const uint32_t* ids_end = terms.word_ids() + terms.size();
+    const uint32_t* id_it = std::lower_bound(terms.word_ids(), ids_end, word_id);
     
-    if (term_it != terms.end() && term_it->word_id == word_id) {
-        return term_it->frequency;
+    if (id_it != ids_end && *id_it == word_id) {
+        return terms.frequencies()[id_it - terms.word_ids()];
     }
     
     return 0;
 }
 
 bool ForwardIndex::save_to_binary(const std::string& file_path) {
-    std::ofstream out(file_path, std::ios::binary);
-    if (!out.is_open()) {
-        std::cerr << "Error: Cannot open file " << file_path << " for writing" << std::endl;
+    if (!MappedForwardIndex::write(file_path, *this)) {
         return false;
     }
-    
-    // Write header: total_documents, total_terms, next_doc_id
-    out.write(reinterpret_cast<const char*>(&total_documents), sizeof(total_documents));
-    out.write(reinterpret_cast<const char*>(&total_terms), sizeof(total_terms));
-    out.write(reinterpret_cast<const char*>(&next_doc_id), sizeof(next_doc_id));
-    
-    // Write number of documents
-    uint32_t num_docs = forward_index.size();
-    out.write(reinterpret_cast<const char*>(&num_docs), sizeof(num_docs));
-    
-    // Write each document
-    for (const auto& entry : forward_index) {
-        const DocumentIndex& doc = entry.second;
-        
-        // Write doc_id (string)
-        uint32_t doc_id_len = doc.doc_id.length();
-        out.write(reinterpret_cast<const char*>(&doc_id_len), sizeof(doc_id_len));
-        out.write(doc.doc_id.c_str(), doc_id_len);
-        
-        // Write title (string)
-        uint32_t title_len = doc.title.length();
-        out.write(reinterpret_cast<const char*>(&title_len), sizeof(title_len));
-        out.write(doc.title.c_str(), title_len);
-        
-        // Write abstract_text (string)
-        uint32_t abstract_len = doc.abstract_text.length();
-        out.write(reinterpret_cast<const char*>(&abstract_len), sizeof(abstract_len));
-        out.write(doc.abstract_text.c_str(), abstract_len);
-        
-        // Write doc_length
-        out.write(reinterpret_cast<const char*>(&doc.doc_length), sizeof(doc.doc_length));
-        
-        // Write number of unique terms
-        uint32_t num_terms = doc.terms.size();
-        out.write(reinterpret_cast<const char*>(&num_terms), sizeof(num_terms));
-        
-        // Write each term posting (word_id and frequency only)
-        for (const auto& term : doc.terms) {
-            out.write(reinterpret_cast<const char*>(&term.word_id), sizeof(term.word_id));
-            out.write(reinterpret_cast<const char*>(&term.frequency), sizeof(term.frequency));
-        }
-    }
-    
-    out.close();
     std::cout << "Forward index saved to " << file_path << std::endl;
     return true;
 }
 
 bool ForwardIndex::load_from_binary(const std::string& file_path) {
-    std::ifstream in(file_path, std::ios::binary);
-    if (!in.is_open()) {
-        std::cerr << "Error: Cannot open file " << file_path << " for reading" << std::endl;
+    MappedForwardIndex mapped;
+    if (!mapped.open(file_path)) {
         return false;
     }
     
     clear();
     
-    // Read header
-    in.read(reinterpret_cast<char*>(&total_documents), sizeof(total_documents));
-    in.read(reinterpret_cast<char*>(&total_terms), sizeof(total_terms));
-    in.read(reinterpret_cast<char*>(&next_doc_id), sizeof(next_doc_id));
-    
-    // Read number of documents
-    uint32_t num_docs;
-    in.read(reinterpret_cast<char*>(&num_docs), sizeof(num_docs));
+    // The columns are stored exactly as held in memory, so they are copied
+    // in bulk; only the per-document records and the cord_uid map are rebuilt
+    size_t num_docs = mapped.get_size();
+    size_t num_postings = mapped.get_posting_count();
+    term_offsets.assign(mapped.get_term_offsets(), mapped.get_term_offsets() + num_docs + 1);
+    term_word_ids.assign(mapped.get_word_ids(), mapped.get_word_ids() + num_postings);
+    term_frequencies.assign(mapped.get_frequencies(), mapped.get_frequencies() + num_postings);
     
-    // Read each document
+    documents.resize(num_docs);
+    doc_id_map.reserve(num_docs);
     for (uint32_t i = 0; i < num_docs; ++i) {
-        DocumentIndex doc;
-        
-        // Read doc_id
-        uint32_t doc_id_len;
-        in.read(reinterpret_cast<char*>(&doc_id_len), sizeof(doc_id_len));
-        doc.doc_id.resize(doc_id_len);
-        in.read(&doc.doc_id[0], doc_id_len);
-        
-        // Read title
-        uint32_t title_len;
-        in.read(reinterpret_cast<char*>(&title_len), sizeof(title_len));
-        doc.title.resize(title_len);
-        in.read(&doc.title[0], title_len);
-        
-        // Read abstract_text
-        uint32_t abstract_len;
-        in.read(reinterpret_cast<char*>(&abstract_len), sizeof(abstract_len));
-        doc.abstract_text.resize(abstract_len);
-        in.read(&doc.abstract_text[0], abstract_len);
-        
-        // Read doc_length
-        in.read(reinterpret_cast<char*>(&doc.doc_length), sizeof(doc.doc_length));
-        
-        // Read number of unique terms
-        uint32_t num_terms;
-        in.read(reinterpret_cast<char*>(&num_terms), sizeof(num_terms));
-        doc.terms.resize(num_terms);
-        
-        // Read each term posting
-        for (uint32_t j = 0; j < num_terms; ++j) {
-            TermPosting& term = doc.terms[j];
-            in.read(reinterpret_cast<char*>(&term.word_id), sizeof(term.word_id));
-            in.read(reinterpret_cast<char*>(&term.frequency), sizeof(term.frequency));
-        }
-        
-        forward_index[doc.doc_id] = doc;
-        doc_id_map[doc.doc_id] = i;
+        DocumentIndex& doc = documents[i];
+        doc.doc_id.assign(mapped.get_doc_id(i));
+        doc.doc_length = mapped.get_document_length(i);
+        doc_id_map.emplace(doc.doc_id, i);
     }
     
-    in.close();
+    total_documents = static_cast<uint32_t>(num_docs);
+    total_terms = mapped.get_total_terms();
+    
     std::cout << "Forward index loaded from " << file_path << std::endl;
     return true;
 }
@@ -227,9 +149,10 @@ void ForwardIndex::save_to_csv(const std::string& file_path)
     // CSV header
     out << "doc_id,word_id,frequency\n";
 
-    for (const auto& [doc_id, doc] : forward_index) {
+    for (uint32_t internal_id = 0; internal_id < documents.size(); ++internal_id) {
+        const DocumentIndex& doc = documents[internal_id];
 
-        for (const auto& term : doc.terms) {
+        for (const auto& term : get_document_terms_by_id(internal_id)) {
             out << doc.doc_id << "," 
                 << term.word_id << ","
                 << term.frequency << "\n";
@@ -239,14 +162,6 @@ void ForwardIndex::save_to_csv(const std::string& file_path)
     out.close();
     std::cout << "CSV for forward index saved to " << file_path << "\n";
 }
-std::unordered_map<std::string, DocumentIndex> ForwardIndex:: get_forward_index() const
- {
-    return forward_index;
- }
-std::unordered_map<std::string, uint32_t> ForwardIndex::get_doc_id_map()
-{
-    return doc_id_map;
-}
 void ForwardIndex::save_first_n_to_csv(const std::string& file_path, size_t number_of_docs)
 {
     std::ofstream out(file_path);
@@ -259,11 +174,12 @@ void ForwardIndex::save_first_n_to_csv(const std::string& file_path, size_t numb
     out << "doc_id,word_id,frequency\n";
 
     size_t count = 0;
-    for (const auto& [doc_id, doc] : forward_index) {
+    for (uint32_t internal_id = 0; internal_id < documents.size(); ++internal_id) {
         if (count >= number_of_docs)
             break;
 
-        for (const auto& term : doc.terms) {
+        const DocumentIndex& doc = documents[internal_id];
+        for (const auto& term : get_document_terms_by_id(internal_id)) {
             out << doc.doc_id << "," 
                 << term.word_id << ","
                 << term.frequency << "\n";
@@ -276,10 +192,34 @@ void ForwardIndex::save_first_n_to_csv(const std::string& file_path, size_t numb
     std::cout << "CSV for first " << number_of_docs << " docs saved to " << file_path << "\n";
 }
 
+void ForwardIndex::remap_word_ids(const std::vector<uint32_t>& old_to_new) {
+    // Each document's slice of the two columns is re-sorted as pairs
+    std::vector<TermPosting> terms;
+    for (uint32_t internal_id = 0; internal_id < documents.size(); ++internal_id) {
+        uint32_t first = term_offsets[internal_id];
+        uint32_t last = term_offsets[internal_id + 1];
+        
+        terms.clear();
+        for (uint32_t i = first; i < last; ++i) {
+            terms.emplace_back(old_to_new[term_word_ids[i]], term_frequencies[i]);
+        }
+        std::sort(terms.begin(), terms.end(),
+                  [](const TermPosting& a, const TermPosting& b) {
+                      return a.word_id < b.word_id;
+                  });
+        for (uint32_t i = first; i < last; ++i) {
+            term_word_ids[i] = terms[i - first].word_id;
+            term_frequencies[i] = terms[i - first].frequency;
+        }
+    }
+}
+
 void ForwardIndex::clear() {
-    forward_index.clear();
+    documents.clear();
     doc_id_map.clear();
-    next_doc_id = 0;
+    term_offsets.assign(1, 0);
+    term_word_ids.clear();
+    term_frequencies.clear();
     total_documents = 0;
     total_terms = 0;
 }
@@ -293,10 +233,7 @@ void ForwardIndex::print_statistics() const
               << get_average_doc_length() << " terms" << std::endl;
     
     // Calculate average unique terms per document
-    uint64_t total_unique_terms = 0;
-    for (const auto& entry : forward_index) {
-        total_unique_terms += entry.second.terms.size();
-    }
+    uint64_t total_unique_terms = term_word_ids.size();
     
     if (total_documents > 0) {
         std::cout << "Average unique terms per document: " << std::fixed << std::setprecision(2)
@@ -309,3 +246,15 @@ double ForwardIndex::get_average_doc_length() const {
     if (total_documents == 0) return 0.0;
     return static_cast<double>(total_terms) / total_documents;
 }
+
+size_t ForwardIndex::get_term_memory_bytes() const {
+    return (term_offsets.capacity() + term_word_ids.capacity() + term_frequencies.capacity())
+           * sizeof(uint32_t);
+}
+
+void ForwardIndex::shrink_to_fit() {
+    term_offsets.shrink_to_fit();
+    term_word_ids.shrink_to_fit();
+    term_frequencies.shrink_to_fit();
+    documents.shrink_to_fit();
+}
@@ -0,0 +1,425 @@
+#include "../include/FstLexicon.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'F', 'S', 'T', 'L'};
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t term_count;
+    uint32_t node_count;
+    uint32_t root;
+    uint32_t reserved;
+    uint64_t byte_count;
+};
+
+// Bytes needed to store v (0 for v == 0)
+uint8_t byte_width(uint32_t v) {
+    uint8_t width = 0;
+    while (v != 0) {
+        width++;
+        v >>= 8;
+    }
+    return width;
+}
+
+void put_varint(std::string& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void put_fixed(std::string& out, uint32_t v, uint8_t width) {
+    for (uint8_t i = 0; i < width; i++) {
+        out.push_back(static_cast<char>(v & 0xFF));
+        v >>= 8;
+    }
+}
+
+// Bounds-checked: false if the varint runs past end or over 5 bytes
+bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint32_t get_fixed(const uint8_t* p, uint8_t width) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < width; i++) {
+        v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+// Decoded view of one packed node. Nodes come from a mapped file, so
+// decode() checks that the node lies inside the FST and that every arc
+// target points strictly below it (the builder compiles children first),
+// which also rules out cycles.
+struct Node {
+    uint32_t offset;
+    bool is_final;
+    uint32_t final_output;
+    uint32_t arc_count;
+    uint8_t output_width;
+    uint8_t target_width;
+    const uint8_t* labels;
+    const uint8_t* outputs;
+    const uint8_t* targets;
+    
+    bool decode(const uint8_t* bytes, size_t byte_count, uint32_t at) {
+        if (at >= byte_count) return false;
+        const uint8_t* p = bytes + at;
+        const uint8_t* end = bytes + byte_count;
+        offset = at;
+        uint8_t flags = *p++;
+        is_final = (flags & 1) != 0;
+        output_width = (flags >> 1) & 7;
+        target_width = (flags >> 4) & 7;
+        final_output = 0;
+        if (output_width > 4 || target_width > 4 || !get_varint(p, end, arc_count) ||
+            (is_final && !get_varint(p, end, final_output)) ||
+            arc_count > static_cast<size_t>(end - p) / (1 + output_width + target_width)) {
+            return false;
+        }
+        labels = p;
+        outputs = labels + arc_count;
+        targets = outputs + static_cast<size_t>(arc_count) * output_width;
+        return true;
+    }
+    
+    uint32_t output(uint32_t i) const { return get_fixed(outputs + i * output_width, output_width); }
+    
+    // Offset of arc i's target, or UINT32_MAX if it does not point below this node
+    uint32_t target(uint32_t i) const {
+        uint32_t t = get_fixed(targets + i * target_width, target_width);
+        return t < offset ? t : UINT32_MAX;
+    }
+    
+    // Index of the arc labelled c, or arc_count
+    uint32_t find(uint8_t c) const {
+        const void* hit = std::memchr(labels, c, arc_count);
+        return hit ? static_cast<uint32_t>(static_cast<const uint8_t*>(hit) - labels) : arc_count;
+    }
+};
+
+// Incremental construction of a minimal FST from sorted input
+class FstBuilder {
+public:
+    explicit FstBuilder(std::vector<uint8_t>& bytes) : bytes(bytes), node_count(0) {
+        frontier.resize(1);
+    }
+    
+    void add(std::string_view word, uint32_t output) {
+        // Nodes of the previous word beyond the shared prefix are complete
+        size_t prefix = 0;
+        while (prefix < previous.size() && prefix < word.size() && previous[prefix] == word[prefix]) {
+            prefix++;
+        }
+        freeze_tail(prefix + 1);
+        
+        if (frontier.size() < word.size() + 1) {
+            frontier.resize(word.size() + 1);
+        }
+        for (size_t i = prefix + 1; i <= word.size(); i++) {
+            frontier[i - 1].arcs.push_back(PendingArc{static_cast<uint8_t>(word[i - 1]), 0, 0});
+        }
+        frontier[word.size()].is_final = true;
+        frontier[word.size()].final_output = 0;
+        
+        // Keep only the common part of the output on shared arcs and push
+        // the rest of the older words' output one node further
+        for (size_t i = 1; i <= prefix; i++) {
+            PendingArc& arc = frontier[i - 1].arcs.back();
+            uint32_t common = std::min(arc.output, output);
+            uint32_t suffix = arc.output - common;
+            arc.output = common;
+            if (suffix != 0) {
+                UncompiledNode& next = frontier[i];
+                for (auto& a : next.arcs) a.output += suffix;
+                if (next.is_final) next.final_output += suffix;
+            }
+            output -= common;
+        }
+        
+        // The first arc private to this word carries what is left
+        frontier[prefix].arcs.back().output = output;
+        previous.assign(word.data(), word.size());
+    }
+    
+    // Compile everything that is left; returns the root offset
+    uint32_t finish() {
+        freeze_tail(1);
+        return compile(frontier[0]);
+    }
+    
+    uint32_t get_node_count() const { return node_count; }
+    
+private:
+    struct PendingArc {
+        uint8_t label;
+        uint32_t output;
+        uint32_t target;   // offset of the compiled target node
+    };
+    
+    struct UncompiledNode {
+        std::vector<PendingArc> arcs;
+        bool is_final = false;
+        uint32_t final_output = 0;
+    };
+    
+    std::vector<uint8_t>& bytes;
+    std::vector<UncompiledNode> frontier;   // frontier[i] = node after i bytes of previous
+    std::string previous;
+    std::unordered_map<std::string, uint32_t> compiled;   // encoding -> offset (minimization)
+    std::string encoding;
+    uint32_t node_count;
+    
+    void freeze_tail(size_t down_to) {
+        for (size_t i = previous.size(); i >= down_to && i > 0; i--) {
+            uint32_t offset = compile(frontier[i]);
+            frontier[i - 1].arcs.back().target = offset;
+            frontier[i] = UncompiledNode();
+        }
+    }
+    
+    // Equivalent nodes encode to the same bytes (their targets are already
+    // minimal), so the encoding doubles as the minimization key
+    uint32_t compile(const UncompiledNode& node) {
+        uint32_t max_output = 0;
+        uint32_t max_target = 0;
+        for (const auto& arc : node.arcs) {
+            max_output = std::max(max_output, arc.output);
+            max_target = std::max(max_target, arc.target);
+        }
+        uint8_t output_width = byte_width(max_output);
+        uint8_t target_width = byte_width(max_target);
+        
+        encoding.clear();
+        encoding.push_back(static_cast<char>((node.is_final ? 1 : 0) | (output_width << 1) | (target_width << 4)));
+        put_varint(encoding, static_cast<uint32_t>(node.arcs.size()));
+        if (node.is_final) put_varint(encoding, node.final_output);
+        for (const auto& arc : node.arcs) encoding.push_back(static_cast<char>(arc.label));
+        for (const auto& arc : node.arcs) put_fixed(encoding, arc.output, output_width);
+        for (const auto& arc : node.arcs) put_fixed(encoding, arc.target, target_width);
+        
+        auto found = compiled.find(encoding);
+        if (found != compiled.end()) return found->second;
+        
+        uint32_t offset = static_cast<uint32_t>(bytes.size());
+        bytes.insert(bytes.end(), encoding.begin(), encoding.end());
+        compiled.emplace(encoding, offset);
+        node_count++;
+        return offset;
+    }
+};
+
+} // namespace
+
+bool FstLexicon::build(std::vector<std::pair<std::string_view, uint32_t>> terms) {
+    size_t before = terms.size();
+    terms.erase(std::remove_if(terms.begin(), terms.end(), [](const auto& term) {
+        return term.first.empty() || term.first.size() > MAX_TERM_BYTES;
+    }), terms.end());
+    std::sort(terms.begin(), terms.end());
+    
+    file.close();
+    owned.clear();
+    bytes = nullptr;
+    byte_count = 0;
+    term_count = node_count = root = 0;
+    skipped_terms = before - terms.size();
+    for (size_t i = 1; i < terms.size(); i++) {
+        if (terms[i].first == terms[i - 1].first) {
+            std::cerr << "Error: FST term " << terms[i].first << " appears twice" << std::endl;
+            return false;
+        }
+    }
+    
+    FstBuilder builder(owned);
+    for (const auto& [word, word_id] : terms) {
+        builder.add(word, word_id);
+    }
+    root = builder.finish();
+    owned.shrink_to_fit();
+    
+    bytes = owned.data();
+    byte_count = owned.size();
+    term_count = static_cast<uint32_t>(terms.size());
+    node_count = builder.get_node_count();
+    return true;
+}
+
+bool FstLexicon::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot open file " << path << " for writing" << std::endl;
+        return false;
+    }
+    
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.term_count = term_count;
+    header.node_count = node_count;
+    header.root = root;
+    header.byte_count = byte_count;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(bytes), byte_count);
+    out.close();
+    return out.good();
+}
+
+bool FstLexicon::open(const std::string& path) {
+    owned.clear();
+    bytes = nullptr;
+    byte_count = 0;
+    term_count = node_count = root = 0;
+    skipped_terms = 0;
+    
+    if (!file.open(path)) {
+        std::cerr << "Error: Cannot open FST lexicon " << path << std::endl;
+        return false;
+    }
+    
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: " << path << " is not an FST lexicon" << std::endl;
+        file.close();
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        file.size() != sizeof(header) + header.byte_count || header.root >= header.byte_count) {
+        std::cerr << "Error: " << path << " is not a version " << VERSION << " FST lexicon" << std::endl;
+        file.close();
+        return false;
+    }
+    
+    bytes = reinterpret_cast<const uint8_t*>(file.data()) + sizeof(header);
+    byte_count = header.byte_count;
+    root = header.root;
+    term_count = header.term_count;
+    node_count = header.node_count;
+    return true;
+}
+
+uint32_t FstLexicon::get_word_id(std::string_view word) const {
+    if (!bytes) return UINT32_MAX;
+    
+    uint32_t output = 0;
+    Node node;
+    if (!node.decode(bytes, byte_count, root)) return UINT32_MAX;
+    for (char c : word) {
+        uint32_t arc = node.find(static_cast<uint8_t>(c));
+        if (arc == node.arc_count) return UINT32_MAX;
+        output += node.output(arc);
+        if (!node.decode(bytes, byte_count, node.target(arc))) return UINT32_MAX;
+    }
+    return node.is_final ? output + node.final_output : UINT32_MAX;
+}
+
+size_t FstLexicon::for_each_prefix(std::string_view prefix, const Visitor& visitor) const {
+    if (!bytes) return 0;
+    
+    // Follow the prefix, then enumerate everything below it
+    uint32_t output = 0;
+    uint32_t at = root;
+    for (char c : prefix) {
+        Node node;
+        if (!node.decode(bytes, byte_count, at)) return 0;
+        uint32_t arc = node.find(static_cast<uint8_t>(c));
+        if (arc == node.arc_count) return 0;
+        output += node.output(arc);
+        at = node.target(arc);
+    }
+    
+    std::string path(prefix);
+    size_t visited = 0;
+    walk(at, false, output, path, std::string_view(), std::string_view(), visitor, visited);
+    return visited;
+}
+
+size_t FstLexicon::for_each_in_range(std::string_view first, std::string_view last,
+                                     const Visitor& visitor) const {
+    if (!bytes) return 0;
+    
+    std::string path;
+    size_t visited = 0;
+    walk(root, true, 0, path, first, last, visitor, visited);
+    return visited;
+}
+
+// Depth-first walk in byte order from the node at start, whose path is
+// already in path. The stack holds one frame per node on the current path
+// (terms can be thousands of bytes, too deep to recurse on a 1 MB thread
+// stack). While a frame is tight, path equals the first path.size() bytes
+// of first and arcs below first[path.size()] are skipped. Returns false
+// once the visitor or the upper bound stops the walk, or on a corrupt node.
+bool FstLexicon::walk(uint32_t start, bool tight, uint32_t output,
+                      std::string& path, std::string_view first, std::string_view last,
+                      const Visitor& visitor, size_t& visited) const {
+    struct Frame {
+        Node node;
+        uint32_t next_arc;
+        uint32_t output;
+        bool tight;
+    };
+    std::vector<Frame> stack;
+    
+    // Decode a node, report the word ending there and push its frame
+    auto enter = [&](uint32_t node_offset, bool node_tight, uint32_t node_output) {
+        Frame frame;
+        if (!frame.node.decode(bytes, byte_count, node_offset)) return false;
+        
+        // A word ending here precedes all its extensions; while tight it is
+        // only in range if it is first itself
+        if (frame.node.is_final && (!node_tight || path.size() == first.size())) {
+            if (!last.empty() && std::string_view(path) >= last) return false;
+            visited++;
+            if (!visitor(path, node_output + frame.node.final_output)) return false;
+        }
+        frame.next_arc = 0;
+        frame.output = node_output;
+        frame.tight = node_tight;
+        stack.push_back(frame);
+        return true;
+    };
+    
+    if (!enter(start, tight, output)) return false;
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (top.next_arc == top.node.arc_count) {
+            stack.pop_back();
+            if (!stack.empty()) path.pop_back();   // every frame but the first added a byte
+            continue;
+        }
+        
+        uint32_t i = top.next_arc++;
+        uint8_t label = top.node.labels[i];
+        bool child_tight = false;
+        if (top.tight && path.size() < first.size()) {
+            uint8_t bound = static_cast<uint8_t>(first[path.size()]);
+            if (label < bound) continue;
+            child_tight = (label == bound);
+        }
+        
+        uint32_t target = top.node.target(i);
+        uint32_t child_output = top.output + top.node.output(i);
+        path.push_back(static_cast<char>(label));
+        if (!enter(target, child_tight, child_output)) return false;
+    }
+    return true;
+}
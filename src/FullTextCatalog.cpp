@@ -0,0 +1,137 @@
+#include "../include/FullTextCatalog.hpp"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Insert the names of all files in dir that end with suffix, minus the suffix
+size_t scan_directory(const std::string& dir, const std::string& suffix,
+                      std::unordered_set<std::string>& names) {
+    std::error_code ec;
+    fs::directory_iterator it(dir, ec);
+    if (ec) {
+        std::cerr << "Warning: Cannot list " << dir << " (" << ec.message() << ")" << std::endl;
+        return 0;
+    }
+    
+    size_t count = 0;
+    for (const auto& entry : it) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > suffix.size() &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            names.insert(name.substr(0, name.size() - suffix.size()));
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+FullTextCatalog::FullTextCatalog()
+    : built(false), rows(0), rows_with_pdf(0), rows_with_pmc_only(0),
+      multi_sha_rows(0), multi_sha_later_match(0) {}
+
+void FullTextCatalog::build(const std::string& pdf_dir, const std::string& pmc_dir) {
+    this->pdf_dir = pdf_dir;
+    this->pmc_dir = pmc_dir;
+    pdf_files.clear();
+    pmc_files.clear();
+    
+    scan_directory(pdf_dir, ".json", pdf_files);
+    scan_directory(pmc_dir, ".xml.json", pmc_files);
+    
+    built = true;
+    reset_statistics();
+    
+    std::cout << "Full-text catalog: " << pdf_files.size() << " pdf_json files, "
+              << pmc_files.size() << " pmc_json files" << std::endl;
+}
+
+std::string FullTextCatalog::match_sha(const std::string& sha_field, int& position) const {
+    position = -1;
+    
+    // sha fields may hold several hashes separated by ';'
+    size_t start = 0;
+    int index = 0;
+    while (start < sha_field.size()) {
+        size_t end = sha_field.find(';', start);
+        if (end == std::string::npos) end = sha_field.size();
+        
+        std::string sha = sha_field.substr(start, end - start);
+        sha.erase(0, sha.find_first_not_of(" \t"));
+        sha.erase(sha.find_last_not_of(" \t") + 1);
+        
+        if (!sha.empty() && pdf_files.count(sha)) {
+            position = index;
+            return sha;
+        }
+        
+        start = end + 1;
+        index++;
+    }
+    return "";
+}
+
+std::string FullTextCatalog::resolve_pdf(const std::string& sha_field) const {
+    int position;
+    std::string sha = match_sha(sha_field, position);
+    return sha.empty() ? "" : pdf_dir + "/" + sha + ".json";
+}
+
+std::string FullTextCatalog::resolve_pmc(const std::string& pmcid) const {
+    if (pmcid.empty() || !pmc_files.count(pmcid)) return "";
+    return pmc_dir + "/" + pmcid + ".xml.json";
+}
+
+FullTextFiles FullTextCatalog::resolve(const std::string& sha_field, const std::string& pmcid) {
+    FullTextFiles files;
+    
+    int position = -1;
+    std::string sha = match_sha(sha_field, position);
+    if (!sha.empty()) {
+        files.pdf_path = pdf_dir + "/" + sha + ".json";
+    }
+    files.pmc_path = resolve_pmc(pmcid);
+    
+    rows++;
+    if (!files.pdf_path.empty()) rows_with_pdf++;
+    else if (!files.pmc_path.empty()) rows_with_pmc_only++;
+    if (sha_field.find(';') != std::string::npos) {
+        multi_sha_rows++;
+        if (position > 0) multi_sha_later_match++;
+    }
+    
+    return files;
+}
+
+void FullTextCatalog::reset_statistics() {
+    rows = 0;
+    rows_with_pdf = 0;
+    rows_with_pmc_only = 0;
+    multi_sha_rows = 0;
+    multi_sha_later_match = 0;
+}
+
+void FullTextCatalog::print_statistics() const {
+    uint64_t total = rows;
+    uint64_t covered = rows_with_pdf + rows_with_pmc_only;
+    
+    std::cout << "\n=== Full-Text Coverage ===" << std::endl;
+    std::cout << "Catalog: " << pdf_files.size() << " pdf_json, " 
+              << pmc_files.size() << " pmc_json files" << std::endl;
+    std::cout << "Metadata rows resolved: " << total << std::endl;
+    std::cout << "  with pdf_json: " << rows_with_pdf << std::endl;
+    std::cout << "  with pmc_json only: " << rows_with_pmc_only << std::endl;
+    std::cout << "  without full text: " << total - covered << std::endl;
+    std::cout << "  multi-sha rows: " << multi_sha_rows 
+              << " (matched on a later sha: " << multi_sha_later_match << ")" << std::endl;
+    if (total > 0) {
+        std::cout << "Coverage: " << std::fixed << std::setprecision(2)
+                  << 100.0 * covered / total << "%" << std::endl;
+    }
+    std::cout << "==========================\n" << std::endl;
+}
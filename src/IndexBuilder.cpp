@@ -0,0 +1,267 @@
+#include "../include/IndexBuilder.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+#include <string_view>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+IndexBuilder::IndexBuilder()
+    : num_threads(1), next_doc_seq(0),
+      term_sink(lexicon),
+      indexed_documents(0), indexed_tokens(0), input_bytes(0),
+      tokenize_seconds(0), forward_seconds(0), renumber_seconds(0), invert_seconds(0),
+      barrel_seconds(0), save_seconds(0) {}
+
+bool IndexBuilder::add_paper(const Paper& paper) {
+    // A repeated cord_uid is rejected before any of its tokens reach the lexicon
+    if (is_indexed(paper)) return false;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    // Tokens go straight to word ids and per-document counts
+    preprocessor.forEachToken(paper.body_text, term_sink);
+    uint32_t doc_length = term_sink.take_document(terms);
+    input_bytes += paper.body_text.size();
+    
+    auto tokenized = std::chrono::steady_clock::now();
+    tokenize_seconds += std::chrono::duration<double>(tokenized - start).count();
+    
+    if (doc_length == 0) return false;
+    
+    bool added = forward_index.add_document(paper.paper_id, terms, doc_length);
+    if (added) {
+        store_paper(paper);
+        indexed_documents++;
+        indexed_tokens += doc_length;
+    }
+    
+    forward_seconds += seconds_since(tokenized);
+    return added;
+}
+
+bool IndexBuilder::is_indexed(const Paper& paper) const {
+    return forward_index.get_internal_id(paper.paper_id) != UINT32_MAX;
+}
+
+bool IndexBuilder::open_document_store(const std::string& path) {
+    return document_store.open(path);
+}
+
+void IndexBuilder::store_paper(const Paper& paper) {
+    // Store ids follow forward index ids, so only papers it accepted are stored
+    document_store.add_document(paper.paper_id, paper.title, paper.authors,
+                                paper.publish_date, paper.abstract_text);
+}
+
+void IndexBuilder::set_num_threads(unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    num_threads = std::max(1u, threads);
+}
+
+int IndexBuilder::add_papers(const std::vector<Paper>& papers) {
+    // Repeated cord_uids are dropped before tokenizing, so none of their
+    // tokens reach either lexicon and first-sight order (hence every word
+    // id) does not depend on the thread count. Within a batch only the
+    // first row of a cord_uid is considered.
+    std::vector<const Paper*> batch;
+    std::unordered_set<std::string_view> batch_ids;
+    batch.reserve(papers.size());
+    for (const auto& paper : papers) {
+        if (!is_indexed(paper) && batch_ids.insert(paper.paper_id).second) {
+            batch.push_back(&paper);
+        }
+    }
+    
+    int indexed = 0;
+    
+    if (num_threads <= 1) {
+        for (const Paper* paper : batch) {
+            if (add_paper(*paper)) indexed++;
+        }
+        return indexed;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    tokenize_parallel(batch);
+    auto tokenized_at = std::chrono::steady_clock::now();
+    tokenize_seconds += std::chrono::duration<double>(tokenized_at - start).count();
+    
+    for (size_t i = 0; i < batch.size(); i++) {
+        input_bytes += batch[i]->body_text.size();
+        if (tokenized[i].length == 0) continue;
+        if (commit_paper(*batch[i], tokenized[i])) indexed++;
+    }
+    
+    forward_seconds += seconds_since(tokenized_at);
+    return indexed;
+}
+
+void IndexBuilder::tokenize_parallel(const std::vector<const Paper*>& papers) {
+    unsigned worker_count = std::min<size_t>(num_threads, papers.size());
+    while (workers.size() < worker_count) {
+        workers.push_back(std::make_unique<TokenizerWorker>(shared_lexicon));
+    }
+    if (tokenized.size() < papers.size()) {
+        tokenized.resize(papers.size());
+    }
+    
+    // Workers claim papers from a shared counter, so each one sees its
+    // papers in increasing stream order (as ConcurrentTermSink requires)
+    uint64_t first_seq = next_doc_seq;
+    std::atomic<size_t> next_paper(0);
+    
+    auto run = [&](TokenizerWorker& worker) {
+        worker.preprocessor = preprocessor;   // pick up the current settings
+        size_t i;
+        while ((i = next_paper.fetch_add(1)) < papers.size()) {
+            worker.sink.begin_document(first_seq + i);
+            worker.preprocessor.forEachToken(papers[i]->body_text, worker.sink);
+            tokenized[i].length = worker.sink.take_document(tokenized[i].terms);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < worker_count; t++) {
+        threads.emplace_back(run, std::ref(*workers[t]));
+    }
+    run(*workers[0]); // calling thread is worker 0
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    next_doc_seq += papers.size();
+    shared_lexicon.finalize();
+}
+
+bool IndexBuilder::commit_paper(const Paper& paper, TokenizedPaper& result) {
+    // Final ids follow first sight, so sorting by them and adding the words
+    // in that order makes the lexicon hand out exactly the same ids
+    for (auto& posting : result.terms) {
+        posting.word_id = shared_lexicon.get_final_id(posting.word_id);
+    }
+    std::sort(result.terms.begin(), result.terms.end(),
+              [](const TermPosting& a, const TermPosting& b) { return a.word_id < b.word_id; });
+    for (auto& posting : result.terms) {
+        posting.word_id = lexicon.add_word(shared_lexicon.get_word(posting.word_id), posting.frequency);
+    }
+    // Only out of order if add_paper() also extended the lexicon
+    if (!std::is_sorted(result.terms.begin(), result.terms.end(),
+                        [](const TermPosting& a, const TermPosting& b) { return a.word_id < b.word_id; })) {
+        std::sort(result.terms.begin(), result.terms.end(),
+                  [](const TermPosting& a, const TermPosting& b) { return a.word_id < b.word_id; });
+    }
+    
+    bool added = forward_index.add_document(paper.paper_id, result.terms, result.length);
+    if (added) {
+        store_paper(paper);
+        indexed_documents++;
+        indexed_tokens += result.length;
+    }
+    return added;
+}
+
+void IndexBuilder::renumber_by_frequency() {
+    auto start = std::chrono::steady_clock::now();
+    
+    std::vector<uint32_t> old_to_new = lexicon.renumber_by_frequency();
+    forward_index.remap_word_ids(old_to_new);
+    
+    renumber_seconds = seconds_since(start);
+    
+    if (!reverse_lex.empty()) {
+        build_inverted_index();
+    }
+}
+
+void IndexBuilder::build_inverted_index() {
+    auto start = std::chrono::steady_clock::now();
+    
+    forward_index.shrink_to_fit();   // the forward index is complete
+    inverted_index.clear();
+    reverse_lex = lexicon.build_reverse_lexicon();
+    
+    // df / cf / max tf per word id, gathered while inverting
+    std::vector<TermStats> stats(reverse_lex.size());
+    
+    // Documents in internal id order, so every posting list is sorted by doc id
+    std::vector<std::pair<uint32_t, uint32_t>> doc_terms;
+    forward_index.for_each_document([&](uint32_t doc_num_id, const DocumentIndex&, TermList terms) {
+        doc_terms.clear();
+        for (const auto& t : terms) {
+            doc_terms.emplace_back(t.word_id, t.frequency);
+            
+            TermStats& term = stats[t.word_id];
+            term.document_frequency++;
+            term.collection_frequency += t.frequency;
+            term.max_term_frequency = std::max(term.max_term_frequency, t.frequency);
+        }
+        inverted_index.add_document(doc_num_id, doc_terms);
+    });
+    
+    // Each posting is a (doc_id, frequency) pair of uint32 on disk
+    for (uint32_t word_id = 0; word_id < stats.size(); word_id++) {
+        if (stats[word_id].document_frequency == 0) continue;
+        stats[word_id].posting_bytes = stats[word_id].document_frequency * 2 * sizeof(uint32_t);
+        lexicon.set_term_stats(word_id, stats[word_id]);
+    }
+    
+    invert_seconds = seconds_since(start);
+}
+
+bool IndexBuilder::create_barrels(const std::string& barrel_dir, uint32_t num_barrels) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = inverted_index.create_barrels(barrel_dir, reverse_lex, num_barrels);
+    barrel_seconds = seconds_since(start);
+    return ok;
+}
+
+void IndexBuilder::save(const std::string& indices_path) {
+    auto start = std::chrono::steady_clock::now();
+    lexicon.save_to_binary(indices_path + "lexicon.bin");
+    lexicon.save_to_fst(indices_path + "lexicon.fst");
+    forward_index.save_to_binary(indices_path + "forward_index.bin");
+    if (document_store.is_open()) {
+        // close() flushes the last block, so the totals are read after it
+        document_store.close();
+        std::cout << "Document store: " << document_store.get_document_count() << " documents, "
+                  << document_store.get_raw_bytes() << " -> "
+                  << document_store.get_compressed_bytes() << " bytes" << std::endl;
+    }
+    inverted_index.save_to_binary(indices_path + "inverted_index.bin", reverse_lex);
+    save_seconds = seconds_since(start);
+}
+
+void IndexBuilder::print_timing() const {
+    auto rate = [](double count, double seconds) { return seconds > 0 ? count / seconds : 0.0; };
+    
+    std::cout << "\n=== Index Build Timing ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Tokenize + lexicon:   " << tokenize_seconds << " s ("
+              << std::setprecision(0) << rate(static_cast<double>(indexed_tokens), tokenize_seconds)
+              << " tokens/sec, " << std::setprecision(2)
+              << rate(input_bytes / (1024.0 * 1024.0), tokenize_seconds) << " MB/s)" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "Forward index insert: " << forward_seconds << " s" << std::endl;
+    if (renumber_seconds > 0) {
+        std::cout << "Renumber by freq:     " << renumber_seconds << " s" << std::endl;
+    }
+    std::cout << "Inverted index:       " << invert_seconds << " s" << std::endl;
+    std::cout << "Barrels:              " << barrel_seconds << " s" << std::endl;
+    std::cout << "Save:                 " << save_seconds << " s" << std::endl;
+    std::cout << "Documents: " << indexed_documents << ", tokens: " << indexed_tokens
+              << " (each tokenized once, " << num_threads << " tokenizer threads)" << std::endl;
+    std::cout << "==========================\n" << std::endl;
+}
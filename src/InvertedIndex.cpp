@@ -45,7 +45,7 @@ InvertedIndex::get_terms(uint32_t word_id)
 }
 
 void InvertedIndex::save_to_csv(const std::string& file_path,
-    const std::unordered_map<uint32_t, std::string>& reverse_lex) const
+    const ReverseLexicon& reverse_lex) const
 {
     std::ofstream out(file_path);
     if (!out.is_open()) {
@@ -56,7 +56,7 @@ void InvertedIndex::save_to_csv(const std::string& file_path,
     out << "word_id,word,doc_id,frequency\n";
     for (const auto& [word_id, postings] : inverted_index) 
     {
-        std::string word = reverse_lex.at(word_id);
+        std::string_view word = reverse_lex.get_word(word_id);
         for (const auto& posting : postings) {
             out << word_id << "," << word << "," 
                 << posting.first << "," << posting.second << "\n";
@@ -67,7 +67,7 @@ void InvertedIndex::save_to_csv(const std::string& file_path,
 }
 
 void InvertedIndex::save_first_n_to_csv(const std::string& file_path,
-    const std::unordered_map<uint32_t, std::string>& reverse_lex, size_t num) const
+    const ReverseLexicon& reverse_lex, size_t num) const
 {
     std::ofstream out(file_path);
     if (!out.is_open()) {
@@ -80,7 +80,7 @@ void InvertedIndex::save_first_n_to_csv(const std::string& file_path,
     for (const auto& [word_id, postings] : inverted_index) 
     {
         if (n >= num) break;
-        std::string word = reverse_lex.at(word_id);
+        std::string_view word = reverse_lex.get_word(word_id);
         for (const auto& posting : postings) {
             out << word_id << "," << word << "," 
                 << posting.first << "," << posting.second << "\n";
@@ -94,7 +94,7 @@ void InvertedIndex::save_first_n_to_csv(const std::string& file_path,
 
 void InvertedIndex::save_to_binary(
     const std::string& file_path, 
-    const std::unordered_map<uint32_t, std::string>& reverse_lex) const
+    const ReverseLexicon& reverse_lex) const
 {
     std::ofstream out(file_path, std::ios::binary);
     if (!out.is_open()) 
@@ -109,10 +109,10 @@ void InvertedIndex::save_to_binary(
     for (const auto& [word_id, postings] : inverted_index) {
         out.write(reinterpret_cast<const char*>(&word_id), sizeof(word_id));
 
-        const std::string& word = reverse_lex.at(word_id);
+        std::string_view word = reverse_lex.get_word(word_id);
         uint32_t word_len = word.size();
         out.write(reinterpret_cast<const char*>(&word_len), sizeof(word_len));
-        out.write(word.c_str(), word_len);
+        out.write(word.data(), word_len);
 
         uint32_t num_postings = postings.size();
         out.write(reinterpret_cast<const char*>(&num_postings), sizeof(num_postings));
@@ -129,7 +129,7 @@ void InvertedIndex::save_to_binary(
 
 bool InvertedIndex::load_from_binary(
     const std::string& file_path, 
-    std::unordered_map<uint32_t, std::string>& reverse_lex)
+    ReverseLexicon& reverse_lex)
 {
     std::ifstream in(file_path, std::ios::binary);
     if (!in.is_open()) {
@@ -152,7 +152,7 @@ bool InvertedIndex::load_from_binary(
 
         std::string word(word_len, '\0');
         in.read(&word[0], word_len);
-        reverse_lex[word_id] = word;
+        reverse_lex.set_word(word_id, word);
 
         uint32_t num_postings;
         in.read(reinterpret_cast<char*>(&num_postings), sizeof(num_postings));
@@ -204,6 +204,7 @@ void InvertedIndex::print_statistics() const
 void InvertedIndex::clear()
 {
     inverted_index.clear();
+    barrel_words.clear();
     currently_loaded_barrel = -1;
 }
 
@@ -211,7 +212,7 @@ void InvertedIndex::clear()
 
 bool InvertedIndex::create_barrels(
     const std::string& barrel_dir,
-    const std::unordered_map<uint32_t, std::string>& reverse_lex,
+    const ReverseLexicon& reverse_lex,
     uint32_t num_barrels)
 {
     if (inverted_index.empty()) {
@@ -251,11 +252,12 @@ bool InvertedIndex::create_barrels(
             end_id = max_word_id;
         }
         
-        std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, uint32_t>>> barrel_data;
+        // Posting lists are written straight from the index, not copied
+        std::unordered_map<uint32_t, PostingList> barrel_data;
         
         for (const auto& [word_id, postings] : inverted_index) {
             if (word_id >= start_id && word_id <= end_id) {
-                barrel_data[word_id] = postings;
+                barrel_data[word_id] = PostingList(postings);
             }
         }
         
@@ -283,10 +285,10 @@ bool InvertedIndex::create_barrels(
         for (const auto& [word_id, postings] : barrel_data) {
             out.write(reinterpret_cast<const char*>(&word_id), sizeof(word_id));
             
-            const std::string& word = reverse_lex.at(word_id);
+            std::string_view word = reverse_lex.get_word(word_id);
             uint32_t word_len = word.size();
             out.write(reinterpret_cast<const char*>(&word_len), sizeof(word_len));
-            out.write(word.c_str(), word_len);
+            out.write(word.data(), word_len);
             
             uint32_t num_postings = postings.size();
             out.write(reinterpret_cast<const char*>(&num_postings), sizeof(num_postings));
@@ -393,7 +395,7 @@ int InvertedIndex::find_barrel_index(uint32_t word_id) const
 
 bool InvertedIndex::load_barrel_for_word(
     uint32_t word_id,
-    std::unordered_map<uint32_t, std::string>& reverse_lex)
+    const ReverseLexicon& reverse_lex)
 {
     int barrel_idx = find_barrel_index(word_id);
     
@@ -407,7 +409,7 @@ bool InvertedIndex::load_barrel_for_word(
 
 bool InvertedIndex::load_barrel_by_index(
     int barrel_idx,
-    std::unordered_map<uint32_t, std::string>& reverse_lex)
+    const ReverseLexicon& reverse_lex)
 {
     if (barrel_idx < 0 || barrel_idx >= static_cast<int>(barrel_metadata.size())) {
         std::cerr << "Error: Invalid barrel index " << barrel_idx << "\n";
@@ -428,6 +430,7 @@ bool InvertedIndex::load_barrel_by_index(
     }
     
     inverted_index.clear();
+    barrel_words.clear();
     
     uint32_t barrel_id, start_id, end_id;
     in.read(reinterpret_cast<char*>(&barrel_id), sizeof(barrel_id));
@@ -446,7 +449,9 @@ bool InvertedIndex::load_barrel_by_index(
         
         std::string word(word_len, '\0');
         in.read(&word[0], word_len);
-        reverse_lex[word_id] = word;
+        if (!reverse_lex.contains(word_id)) {
+            barrel_words.set_word(word_id, word);
+        }
         
         uint32_t num_postings;
         in.read(reinterpret_cast<char*>(&num_postings), sizeof(num_postings));
@@ -499,7 +504,7 @@ void InvertedIndex::print_barrel_info() const
 
 bool InvertedIndex::export_barrels_to_csv(
     const std::string& barrel_dir,
-    const std::unordered_map<uint32_t, std::string>& reverse_lex)
+    const ReverseLexicon& reverse_lex)
 {
     if (barrel_metadata.empty()) {
         std::cerr << "Error: No barrels loaded. Call load_barrel_metadata() first.\n";
@@ -509,9 +514,7 @@ bool InvertedIndex::export_barrels_to_csv(
     std::cout << "\n=== Exporting Barrels to CSV ===\n";
     
     for (size_t i = 0; i < barrel_metadata.size(); ++i) {
-        std::unordered_map<uint32_t, std::string> temp_reverse_lex = reverse_lex;
-        
-        if (!const_cast<InvertedIndex*>(this)->load_barrel_by_index(static_cast<int>(i), temp_reverse_lex)) {
+        if (!load_barrel_by_index(static_cast<int>(i), reverse_lex)) {
             std::cerr << "Failed to load barrel " << i << "\n";
             continue;
         }
@@ -526,7 +529,7 @@ bool InvertedIndex::export_barrels_to_csv(
         out << "word_id,word,doc_id,frequency\n";
         
         for (const auto& [word_id, postings] : inverted_index) {
-            const std::string& word = temp_reverse_lex[word_id];
+            std::string_view word = get_word(word_id, reverse_lex);
             for (const auto& [doc_id, freq] : postings) {
                 out << word_id << "," << word << "," << doc_id << "," << freq << "\n";
             }
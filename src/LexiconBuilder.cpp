@@ -1,4 +1,6 @@
 #include "../include/LexiconBuilder.hpp"
+#include "../include/MappedLexicon.hpp"
+#include "../include/FstLexicon.hpp"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -8,60 +10,61 @@
 
 LexiconBuilder::LexiconBuilder():next_word_id(0){}   // constructor initializes next word id to 0
 
-uint32_t LexiconBuilder::add_word(const std::string &word, uint32_t count)
+uint32_t LexiconBuilder::add_word(std::string_view word, uint32_t count)
 {
-    // check if the word already exists in the lexicon
-    auto target = lexicon_data.find(word);
+    // intern the word; an existing word keeps its term index
+    bool inserted = false;
+    uint32_t index = terms.insert(word, inserted);
 
-    if(target != lexicon_data.end())
+    if(!inserted)
     {
         // if found, update its frequency and return its already assigned id
-        target->second.second += count;
-        return target->second.first;
+        details[index].second += count;
+        return details[index].first;
     }
 
     // assign a new word id since the word is not present
     uint32_t word_id = next_word_id++;
-    lexicon_data[word] = { word_id, count };
+    details.emplace_back(word_id, count);
 
     // return the new id
     return word_id;
 }
 
-bool LexiconBuilder::contains(const std::string& word)
+bool LexiconBuilder::contains(std::string_view word)const
 {
-    // simply check if a word exists in the map
-    return lexicon_data.find(word) != lexicon_data.end();
+    // simply check if a word exists in the table
+    return terms.find(word) != TermTable::NPOS;
 }
 
-const std::pair<uint32_t,uint32_t>* LexiconBuilder::get_word_details(const std::string& word)
+const std::pair<uint32_t,uint32_t>* LexiconBuilder::get_word_details(std::string_view word)
 {
     // finds the word and returns a pointer to its (word_id, freq) pair
-    auto a = lexicon_data.find(word);
-    if(a != lexicon_data.end())
-        return &a->second;
+    uint32_t index = terms.find(word);
+    if(index != TermTable::NPOS)
+        return &details[index];
 
     // return nullptr if the word is not found
     return nullptr;
 }
 
-uint32_t LexiconBuilder::get_word_id(const std::string& word)const
+uint32_t LexiconBuilder::get_word_id(std::string_view word)const
 {
     // return the stored id if the word exists
-    auto a = lexicon_data.find(word);
-    if(a != lexicon_data.end())
-        return a->second.first;
+    uint32_t index = terms.find(word);
+    if(index != TermTable::NPOS)
+        return details[index].first;
 
     // return max uint32_t to indicate "not found"
     return UINT32_MAX;
 }
 
-uint32_t LexiconBuilder::get_frequency(const std::string& word)const
+uint32_t LexiconBuilder::get_frequency(std::string_view word)const
 {
     // return the frequency of the word if found
-    auto a = lexicon_data.find(word);
-    if(a != lexicon_data.end())
-        return a->second.second;
+    uint32_t index = terms.find(word);
+    if(index != TermTable::NPOS)
+        return details[index].second;
 
     // again return UINT32_MAX for missing word
     return UINT32_MAX;
@@ -70,7 +73,30 @@ uint32_t LexiconBuilder::get_frequency(const std::string& word)const
 size_t LexiconBuilder::get_size()const
 {
     // returns how many words are currently stored in the lexicon
-    return lexicon_data.size();
+    return terms.size();
+}
+
+void LexiconBuilder::set_term_stats(uint32_t word_id, const TermStats& stats)
+{
+    if(word_id >= term_stats.size())
+        term_stats.resize(std::max<uint32_t>(next_word_id, word_id + 1));
+    term_stats[word_id] = stats;
+}
+
+const TermStats* LexiconBuilder::get_term_stats(uint32_t word_id)const
+{
+    // a zero df means the term never reached the inverted index
+    if(word_id >= term_stats.size() || term_stats[word_id].document_frequency == 0)
+        return nullptr;
+    return &term_stats[word_id];
+}
+
+const TermStats* LexiconBuilder::get_term_stats(std::string_view word)const
+{
+    uint32_t index = terms.find(word);
+    if(index == TermTable::NPOS)
+        return nullptr;
+    return get_term_stats(details[index].first);
 }
 
 void LexiconBuilder::save_to_csv(const std::string& csv_path)
@@ -83,20 +109,24 @@ void LexiconBuilder::save_to_csv(const std::string& csv_path)
         return;
     }
 
-    // unordered_map is not sorted, so we copy data into a vector first
-    std::vector<std::pair<std::string, std::pair<uint32_t,uint32_t>>> sorted(
-    lexicon_data.begin(), lexicon_data.end());
-
-    // sort by frequency 
+    // sort term indexes by frequency; ties keep word id order so the
+    // file is the same on every run
+    std::vector<uint32_t> sorted(terms.size());
+    for(uint32_t i = 0; i < sorted.size(); i++)
+        sorted[i] = i;
     std::sort(sorted.begin(), sorted.end(),
-          [](const auto& a, const auto& b){ return a.second.second > b.second.second; });
+          [&](uint32_t a, uint32_t b){
+              if(details[a].second != details[b].second)
+                  return details[a].second > details[b].second;
+              return details[a].first < details[b].first;
+          });
 
     // write CSV header
     out << "word,word_id,frequency\n";
 
     // write every entry in the sorted order
-    for(const auto &i: sorted)
-        out << '\"' << i.first << "\"," << i.second.first << ',' << i.second.second << '\n';
+    for(uint32_t i: sorted)
+        out << '\"' << terms.get_term(i) << "\"," << details[i].first << ',' << details[i].second << '\n';
 
     out.close();  // done writing
 }
@@ -132,6 +162,10 @@ bool LexiconBuilder::load_from_csv(const std::string& csv_path)
             continue; // skip malformed lines
         }
 
+        // save_to_csv quotes every word
+        if (word.size() >= 2 && word.front() == '"' && word.back() == '"')
+            word = word.substr(1, word.size() - 2);
+
         uint32_t word_id = 0;
         uint32_t freq = 0;
         std::stringstream id_stream(word_id_str);
@@ -141,8 +175,13 @@ bool LexiconBuilder::load_from_csv(const std::string& csv_path)
         if (!(id_stream >> word_id)) continue; // if parsing fails, skip line
         if (!(freq_stream >> freq)) continue;
 
-        // store the parsed data
-        lexicon_data[word] = {word_id, freq};
+        // store the parsed data (a repeated word keeps the last line)
+        bool inserted = false;
+        uint32_t index = terms.insert(word, inserted);
+        if(inserted)
+            details.emplace_back(word_id, freq);
+        else
+            details[index] = {word_id, freq};
 
         // keep track of the highest id so new words get correct ids later
         if (word_id > max_id) max_id = word_id;
@@ -156,19 +195,128 @@ bool LexiconBuilder::load_from_csv(const std::string& csv_path)
     return true;
 }
 
-std::unordered_map<uint32_t,std::string> LexiconBuilder::build_reverse_lexicon()
+bool LexiconBuilder::save_to_binary(const std::string& bin_path)
 {
-    std::unordered_map<uint32_t,std::string> reverse_lexicon;
-   
-    for(auto& [word,details]:lexicon_data)
-        reverse_lexicon[details.first]=word;
+    // the writer sorts the terms and builds the hash index itself
+    std::vector<MappedLexicon::Entry> entries;
+    entries.reserve(terms.size());
+    for(uint32_t i = 0; i < terms.size(); i++)
+    {
+        MappedLexicon::Entry entry = {terms.get_term(i), details[i].first, details[i].second};
+        if(const TermStats* stats = get_term_stats(details[i].first))
+        {
+            entry.document_frequency = stats->document_frequency;
+            entry.max_term_frequency = stats->max_term_frequency;
+            entry.posting_bytes = stats->posting_bytes;
+        }
+        entries.push_back(entry);
+    }
+
+    return MappedLexicon::write(bin_path, std::move(entries));
+}
+
+bool LexiconBuilder::load_from_binary(const std::string& bin_path)
+{
+    MappedLexicon mapped;
+    if(!mapped.open(bin_path))
+        return false;
+
+    clear_lexicon();
+
+    // re-insert in word id order so term indexes follow ids again
+    uint32_t max_id = 0;
+    for(uint32_t word_id = 0; word_id < mapped.get_id_count(); word_id++)
+    {
+        std::string_view word = mapped.get_word(word_id);
+        if(word.empty())
+            continue;
+
+        bool inserted = false;
+        terms.insert(word, inserted);
+        details.emplace_back(word_id, mapped.get_frequency(word_id));
+        max_id = word_id;
+
+        TermStats stats = mapped.get_term_stats(word_id);
+        if(stats.document_frequency > 0)
+            set_term_stats(word_id, stats);
+    }
+
+    next_word_id = terms.size() > 0 ? max_id + 1 : 0;
+    return true;
+}
+
+bool LexiconBuilder::save_to_fst(const std::string& fst_path)
+{
+    std::vector<std::pair<std::string_view,uint32_t>> sorted_terms;
+    sorted_terms.reserve(terms.size());
+    for(uint32_t i = 0; i < terms.size(); i++)
+        sorted_terms.emplace_back(terms.get_term(i), details[i].first);
+
+    FstLexicon fst;
+    if(!fst.build(std::move(sorted_terms)))
+        return false;
+    if(fst.get_skipped_terms() > 0)
+        std::cerr << "Warning: " << fst.get_skipped_terms() << " terms over "
+                  << FstLexicon::MAX_TERM_BYTES << " bytes left out of " << fst_path << std::endl;
+    return fst.save(fst_path);
+}
+
+ReverseLexicon LexiconBuilder::build_reverse_lexicon()const
+{
+    ReverseLexicon reverse_lexicon;
+
+    size_t blob_bytes = 0;
+    for(uint32_t i = 0; i < terms.size(); i++)
+        blob_bytes += terms.get_term(i).size();
+
+    reverse_lexicon.reserve(next_word_id, blob_bytes);
+    for(uint32_t i = 0; i < terms.size(); i++)
+        reverse_lexicon.set_word(details[i].first, terms.get_term(i));
 
     return reverse_lexicon;
 }
 
+std::vector<uint32_t> LexiconBuilder::renumber_by_frequency()
+{
+    // same order as save_to_csv: frequency first, ties by the current id
+    std::vector<uint32_t> sorted(terms.size());
+    for(uint32_t i = 0; i < sorted.size(); i++)
+        sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(),
+          [&](uint32_t a, uint32_t b){
+              if(details[a].second != details[b].second)
+                  return details[a].second > details[b].second;
+              return details[a].first < details[b].first;
+          });
+
+    std::vector<uint32_t> old_to_new(next_word_id, UINT32_MAX);
+    std::vector<TermStats> renumbered_stats(term_stats.empty() ? 0 : sorted.size());
+    for(uint32_t new_id = 0; new_id < sorted.size(); new_id++)
+    {
+        std::pair<uint32_t,uint32_t>& entry = details[sorted[new_id]];
+        old_to_new[entry.first] = new_id;
+        if(entry.first < term_stats.size() && !renumbered_stats.empty())
+            renumbered_stats[new_id] = term_stats[entry.first];
+        entry.first = new_id;
+    }
+    term_stats = std::move(renumbered_stats);
+
+    // ids are dense again after renumbering
+    next_word_id = terms.size();
+    return old_to_new;
+}
+
 void LexiconBuilder::clear_lexicon()
 {
     // simply resets the entire lexicon and id counter
-    lexicon_data.clear();
+    terms.clear();
+    details.clear();
+    term_stats.clear();
     next_word_id = 0;
 }
+
+size_t LexiconBuilder::get_memory_bytes()const
+{
+    return terms.get_memory_bytes() + details.capacity() * sizeof(details[0])
+         + term_stats.capacity() * sizeof(TermStats);
+}
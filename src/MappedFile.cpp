@@ -0,0 +1,153 @@
+#include "../include/MappedFile.hpp"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : map_data(other.map_data), file_size(other.file_size),
+      open_flag(other.open_flag), buffer(std::move(other.buffer)) {
+    other.map_data = nullptr;
+    other.file_size = 0;
+    other.open_flag = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        map_data = other.map_data;
+        file_size = other.file_size;
+        open_flag = other.open_flag;
+        buffer = std::move(other.buffer);
+        other.map_data = nullptr;
+        other.file_size = 0;
+        other.open_flag = false;
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    file_size = static_cast<size_t>(size.QuadPart);
+    
+    if (file_size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            // The view keeps the mapping alive after both handles are closed
+            map_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    
+    if (!map_data && !read_into_buffer(path)) return false;
+    
+    open_flag = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (map_data) {
+        UnmapViewOfFile(map_data);
+        map_data = nullptr;
+    }
+    file_size = 0;
+    open_flag = false;
+}
+
+bool MappedFile::read_into_buffer(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    buffer.resize(file_size);
+    size_t done = 0;
+    while (done < file_size) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(file_size - done, 1u << 30));
+        DWORD got = 0;
+        if (!ReadFile(file, &buffer[done], chunk, &got, nullptr) || got == 0) break;
+        done += got;
+    }
+    CloseHandle(file);
+    
+    file_size = done;
+    return true;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    file_size = static_cast<size_t>(st.st_size);
+    
+    if (file_size > 0 && S_ISREG(st.st_mode)) {
+        void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            map_data = static_cast<const char*>(addr);
+        }
+    }
+    ::close(fd);  // the mapping stays valid after close
+    
+    if (!map_data && !read_into_buffer(path)) return false;
+    
+    open_flag = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (map_data) {
+        munmap(const_cast<char*>(map_data), file_size);
+        map_data = nullptr;
+    }
+    file_size = 0;
+    open_flag = false;
+}
+
+bool MappedFile::read_into_buffer(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    buffer.resize(file_size);
+    size_t done = 0;
+    while (done < file_size) {
+        ssize_t got = pread(fd, &buffer[done], file_size - done, static_cast<off_t>(done));
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+    }
+    ::close(fd);
+    
+    file_size = done;
+    return true;
+}
+
+#endif
@@ -0,0 +1,210 @@
+#include "../include/MappedForwardIndex.hpp"
+#include "../include/MappedLexicon.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char MAGIC[4] = {'F', 'W', 'D', 'X'};
+
+size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+// Byte size of an array section including its padding
+size_t section_bytes(size_t count, size_t element_size) {
+    return align8(count * element_size);
+}
+
+void write_padded(std::ofstream& out, const void* data, size_t bytes) {
+    out.write(static_cast<const char*>(data), bytes);
+    static const char zeros[8] = {};
+    out.write(zeros, align8(bytes) - bytes);
+}
+
+} // namespace
+
+bool MappedForwardIndex::write(const std::string& path, const ForwardIndex& index) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot open file " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    const std::vector<DocumentIndex>& documents = index.get_documents();
+    uint32_t count = static_cast<uint32_t>(documents.size());
+
+    std::vector<uint32_t> lengths, offsets, id_offsets;
+    lengths.reserve(count);
+    offsets.reserve(count + 1);
+    id_offsets.reserve(count + 1);
+    uint32_t postings = 0;
+    uint64_t id_bytes = 0;
+    for (uint32_t d = 0; d < count; d++) {
+        lengths.push_back(documents[d].doc_length);
+        offsets.push_back(postings);
+        postings += static_cast<uint32_t>(index.get_document_terms_by_id(d).size());
+        id_offsets.push_back(static_cast<uint32_t>(id_bytes));
+        id_bytes += documents[d].doc_id.size();
+        if (id_bytes > UINT32_MAX) {
+            std::cerr << "Error: Forward index too large for " << path << std::endl;
+            return false;
+        }
+    }
+    offsets.push_back(postings);
+    id_offsets.push_back(static_cast<uint32_t>(id_bytes));
+
+    // cord_uid hash index at most half full
+    uint32_t slot_total = 16;
+    while (slot_total < static_cast<uint64_t>(count) * 2) slot_total *= 2;
+    std::vector<Slot> slot_values(slot_total, Slot{0, NPOS});
+    for (uint32_t d = 0; d < count; d++) {
+        uint32_t h = MappedLexicon::hash_word(documents[d].doc_id);
+        uint32_t s = h & (slot_total - 1);
+        while (slot_values[s].internal_id != NPOS) s = (s + 1) & (slot_total - 1);
+        slot_values[s] = Slot{h, d};
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.document_count = count;
+    header.slot_count = slot_total;
+    header.total_terms = index.get_total_terms();
+    header.posting_count = postings;
+    header.id_bytes = id_bytes;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    write_padded(out, lengths.data(), lengths.size() * sizeof(uint32_t));
+    write_padded(out, offsets.data(), offsets.size() * sizeof(uint32_t));
+
+    // The two term columns are copied document by document
+    for (int column = 0; column < 2; column++) {
+        for (uint32_t d = 0; d < count; d++) {
+            TermList terms = index.get_document_terms_by_id(d);
+            const uint32_t* values = column == 0 ? terms.word_ids() : terms.frequencies();
+            out.write(reinterpret_cast<const char*>(values), terms.size() * sizeof(uint32_t));
+        }
+        static const char zeros[8] = {};
+        out.write(zeros, section_bytes(postings, sizeof(uint32_t)) - postings * sizeof(uint32_t));
+    }
+
+    write_padded(out, id_offsets.data(), id_offsets.size() * sizeof(uint32_t));
+    write_padded(out, slot_values.data(), slot_values.size() * sizeof(Slot));
+    for (const auto& doc : documents) {
+        out.write(doc.doc_id.data(), doc.doc_id.size());
+    }
+
+    out.close();
+    return out.good();
+}
+
+bool MappedForwardIndex::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: Cannot open forward index " << path << std::endl;
+        return false;
+    }
+
+    const char* base = file.data();
+    Header header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: " << path << " is not a forward index" << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Error: " << path << " is not a version " << VERSION << " forward index" << std::endl;
+        close();
+        return false;
+    }
+
+    // The uint64 counts are bounded by the file size before any product is
+    // taken; the uint32 ones cannot overflow a 64-bit size_t
+    if (header.posting_count > file.size() || header.id_bytes > file.size()) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    size_t expected = sizeof(Header)
+                    + section_bytes(header.document_count, sizeof(uint32_t))
+                    + 2 * section_bytes(static_cast<size_t>(header.document_count) + 1, sizeof(uint32_t))
+                    + 2 * section_bytes(header.posting_count, sizeof(uint32_t))
+                    + section_bytes(header.slot_count, sizeof(Slot))
+                    + header.id_bytes;
+    if (file.size() != expected || header.slot_count == 0 ||
+        (header.slot_count & (header.slot_count - 1)) != 0) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+
+    document_count = header.document_count;
+    slot_count = header.slot_count;
+    total_terms = header.total_terms;
+    posting_count = header.posting_count;
+
+    const char* p = base + sizeof(Header);
+    doc_lengths = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(document_count, sizeof(uint32_t));
+    term_offsets = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(static_cast<size_t>(document_count) + 1, sizeof(uint32_t));
+    word_ids = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(posting_count, sizeof(uint32_t));
+    frequencies = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(posting_count, sizeof(uint32_t));
+    id_offsets = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(static_cast<size_t>(document_count) + 1, sizeof(uint32_t));
+    slots = reinterpret_cast<const Slot*>(p);
+    p += section_bytes(slot_count, sizeof(Slot));
+    ids = p;
+
+    if (!validate(header.id_bytes)) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedForwardIndex::validate(uint64_t id_bytes) const {
+    // Both offset arrays index into their columns: they must start at 0,
+    // never decrease and end exactly at the column size
+    if (term_offsets[0] != 0 || term_offsets[document_count] != posting_count ||
+        id_offsets[0] != 0 || id_offsets[document_count] != id_bytes) {
+        return false;
+    }
+    for (uint32_t i = 0; i < document_count; i++) {
+        if (term_offsets[i + 1] < term_offsets[i] || id_offsets[i + 1] < id_offsets[i]) return false;
+    }
+    // Probing stops at an empty slot, so there must be one
+    bool has_empty = false;
+    for (uint32_t s = 0; s < slot_count; s++) {
+        if (slots[s].internal_id == NPOS) has_empty = true;
+        else if (slots[s].internal_id >= document_count) return false;
+    }
+    return has_empty;
+}
+
+void MappedForwardIndex::close() {
+    file.close();
+    document_count = slot_count = 0;
+    total_terms = posting_count = 0;
+    doc_lengths = term_offsets = word_ids = frequencies = id_offsets = nullptr;
+    slots = nullptr;
+    ids = nullptr;
+}
+
+uint32_t MappedForwardIndex::get_internal_id(std::string_view doc_id) const {
+    if (slot_count == 0) return NPOS;
+    uint32_t h = MappedLexicon::hash_word(doc_id);
+    uint32_t mask = slot_count - 1;
+    for (uint32_t s = h & mask; ; s = (s + 1) & mask) {
+        const Slot& slot = slots[s];
+        if (slot.internal_id == NPOS) return NPOS;
+        if (slot.hash == h && get_doc_id(slot.internal_id) == doc_id) return slot.internal_id;
+    }
+}
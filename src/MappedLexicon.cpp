@@ -0,0 +1,261 @@
+#include "../include/MappedLexicon.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'L', 'E', 'X', 'B'};
+
+size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+// Byte size of an array section including its padding
+size_t section_bytes(size_t count, size_t element_size) {
+    return align8(count * element_size);
+}
+
+template <typename T>
+void write_section(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    static const char zeros[8] = {};
+    out.write(zeros, section_bytes(values.size(), sizeof(T)) - values.size() * sizeof(T));
+}
+
+} // namespace
+
+uint32_t MappedLexicon::hash_word(std::string_view word) {
+    // 64-bit FNV-1a folded to 32 bits
+    uint64_t h = 14695981039346656037ull;
+    for (char c : word) {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+bool MappedLexicon::write(const std::string& path, std::vector<Entry> entries) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot open file " << path << " for writing" << std::endl;
+        return false;
+    }
+    
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.word < b.word; });
+    
+    uint32_t count = static_cast<uint32_t>(entries.size());
+    uint32_t ids = 0;
+    std::vector<uint32_t> offsets, id_values, freq_values, df_values, max_tf_values, bytes_values;
+    offsets.reserve(count + 1);
+    id_values.reserve(count);
+    freq_values.reserve(count);
+    df_values.reserve(count);
+    max_tf_values.reserve(count);
+    bytes_values.reserve(count);
+    
+    uint64_t offset = 0;
+    for (const Entry& entry : entries) {
+        // NPOS marks unused ids, and offsets are uint32 in the file
+        if (entry.word_id == NPOS) {
+            std::cerr << "Error: Word id " << NPOS << " is reserved in " << path << std::endl;
+            return false;
+        }
+        if (offset + entry.word.size() > UINT32_MAX) {
+            std::cerr << "Error: Lexicon too large for " << path << std::endl;
+            return false;
+        }
+        offsets.push_back(static_cast<uint32_t>(offset));
+        offset += entry.word.size();
+        id_values.push_back(entry.word_id);
+        freq_values.push_back(entry.frequency);
+        df_values.push_back(entry.document_frequency);
+        max_tf_values.push_back(entry.max_term_frequency);
+        bytes_values.push_back(entry.posting_bytes);
+        ids = std::max(ids, entry.word_id + 1);
+    }
+    offsets.push_back(static_cast<uint32_t>(offset));
+    
+    std::vector<uint32_t> id_to_sorted(ids, NPOS);
+    for (uint32_t i = 0; i < count; i++) {
+        id_to_sorted[id_values[i]] = i;
+    }
+    
+    // Hash index at most half full
+    uint32_t slot_total = 16;
+    while (slot_total < static_cast<uint64_t>(count) * 2) slot_total *= 2;
+    std::vector<Slot> slot_values(slot_total, Slot{0, NPOS});
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t h = hash_word(entries[i].word);
+        uint32_t s = h & (slot_total - 1);
+        while (slot_values[s].sorted != NPOS) s = (s + 1) & (slot_total - 1);
+        slot_values[s] = Slot{h, i};
+    }
+    
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.term_count = count;
+    header.id_count = ids;
+    header.slot_count = slot_total;
+    header.string_bytes = offset;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    write_section(out, offsets);
+    write_section(out, id_values);
+    write_section(out, freq_values);
+    write_section(out, df_values);
+    write_section(out, max_tf_values);
+    write_section(out, bytes_values);
+    write_section(out, id_to_sorted);
+    write_section(out, slot_values);
+    for (const Entry& entry : entries) {
+        out.write(entry.word.data(), entry.word.size());
+    }
+    
+    out.close();
+    return out.good();
+}
+
+bool MappedLexicon::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        std::cerr << "Error: Cannot open lexicon " << path << std::endl;
+        return false;
+    }
+    
+    const char* base = file.data();
+    Header header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: " << path << " is not a lexicon file" << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "Error: " << path << " is not a version " << VERSION << " lexicon file" << std::endl;
+        close();
+        return false;
+    }
+    
+    // Counts are uint32, so these sums cannot overflow a 64-bit size_t
+    size_t expected = sizeof(Header)
+                    + section_bytes(static_cast<size_t>(header.term_count) + 1, sizeof(uint32_t))
+                    + 5 * section_bytes(header.term_count, sizeof(uint32_t))
+                    + section_bytes(header.id_count, sizeof(uint32_t))
+                    + section_bytes(header.slot_count, sizeof(Slot));
+    if (header.string_bytes > file.size() || file.size() - header.string_bytes != expected ||
+        header.slot_count == 0 || (header.slot_count & (header.slot_count - 1)) != 0) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    
+    term_count = header.term_count;
+    id_count = header.id_count;
+    slot_count = header.slot_count;
+    
+    const char* p = base + sizeof(Header);
+    string_offsets = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(static_cast<size_t>(term_count) + 1, sizeof(uint32_t));
+    word_ids = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(term_count, sizeof(uint32_t));
+    frequencies = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(term_count, sizeof(uint32_t));
+    document_frequencies = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(term_count, sizeof(uint32_t));
+    max_term_frequencies = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(term_count, sizeof(uint32_t));
+    posting_bytes = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(term_count, sizeof(uint32_t));
+    id_to_sorted = reinterpret_cast<const uint32_t*>(p);
+    p += section_bytes(id_count, sizeof(uint32_t));
+    slots = reinterpret_cast<const Slot*>(p);
+    p += section_bytes(slot_count, sizeof(Slot));
+    strings = p;
+    
+    if (!validate(header.string_bytes)) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedLexicon::validate(uint64_t string_bytes) const {
+    // Every index read by the lookups must stay inside its section
+    if (string_offsets[0] != 0 || string_offsets[term_count] != string_bytes) return false;
+    for (uint32_t i = 0; i < term_count; i++) {
+        if (string_offsets[i + 1] < string_offsets[i] || word_ids[i] >= id_count) return false;
+    }
+    for (uint32_t id = 0; id < id_count; id++) {
+        if (id_to_sorted[id] != NPOS && id_to_sorted[id] >= term_count) return false;
+    }
+    // Probing stops at an empty slot, so there must be one
+    bool has_empty = false;
+    for (uint32_t s = 0; s < slot_count; s++) {
+        if (slots[s].sorted == NPOS) has_empty = true;
+        else if (slots[s].sorted >= term_count) return false;
+    }
+    return has_empty;
+}
+
+void MappedLexicon::close() {
+    file.close();
+    term_count = id_count = slot_count = 0;
+    string_offsets = word_ids = frequencies = id_to_sorted = nullptr;
+    document_frequencies = max_term_frequencies = posting_bytes = nullptr;
+    slots = nullptr;
+    strings = nullptr;
+}
+
+uint32_t MappedLexicon::find_sorted(std::string_view word) const {
+    if (slot_count == 0) return NPOS;
+    uint32_t h = hash_word(word);
+    uint32_t mask = slot_count - 1;
+    for (uint32_t s = h & mask; ; s = (s + 1) & mask) {
+        const Slot& slot = slots[s];
+        if (slot.sorted == NPOS) return NPOS;
+        if (slot.hash == h && get_sorted_word(slot.sorted) == word) return slot.sorted;
+    }
+}
+
+uint32_t MappedLexicon::get_word_id(std::string_view word) const {
+    uint32_t i = find_sorted(word);
+    return i == NPOS ? UINT32_MAX : word_ids[i];
+}
+
+uint32_t MappedLexicon::get_frequency(std::string_view word) const {
+    uint32_t i = find_sorted(word);
+    return i == NPOS ? UINT32_MAX : frequencies[i];
+}
+
+std::string_view MappedLexicon::get_word(uint32_t word_id) const {
+    if (word_id >= id_count || id_to_sorted[word_id] == NPOS) return std::string_view();
+    return get_sorted_word(id_to_sorted[word_id]);
+}
+
+uint32_t MappedLexicon::get_frequency(uint32_t word_id) const {
+    if (word_id >= id_count || id_to_sorted[word_id] == NPOS) return UINT32_MAX;
+    return frequencies[id_to_sorted[word_id]];
+}
+
+TermStats MappedLexicon::get_sorted_stats(uint32_t i) const {
+    TermStats stats;
+    stats.document_frequency = document_frequencies[i];
+    stats.collection_frequency = frequencies[i];
+    stats.max_term_frequency = max_term_frequencies[i];
+    stats.posting_bytes = posting_bytes[i];
+    return stats;
+}
+
+TermStats MappedLexicon::get_term_stats(uint32_t word_id) const {
+    if (word_id >= id_count || id_to_sorted[word_id] == NPOS) return TermStats();
+    return get_sorted_stats(id_to_sorted[word_id]);
+}
+
+TermStats MappedLexicon::get_term_stats(std::string_view word) const {
+    uint32_t i = find_sorted(word);
+    return i == NPOS ? TermStats() : get_sorted_stats(i);
+}
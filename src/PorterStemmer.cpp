@@ -0,0 +1,205 @@
+#include "../include/PorterStemmer.hpp"
+#include <cstring>
+
+namespace {
+
+// Suffix rules for steps 2-4. Rules are grouped by the letter the C
+// implementation switches on; within a group the first matching suffix
+// wins, whether or not its measure condition holds.
+struct SuffixRule {
+    char key;
+    std::string_view suffix;
+    std::string_view replacement;
+};
+
+// Step 2: (m>0) suffix -> replacement, keyed by the penultimate letter
+constexpr SuffixRule STEP2_RULES[] = {
+    {'a', "ational", "ate"}, {'a', "tional", "tion"},
+    {'c', "enci", "ence"},   {'c', "anci", "ance"},
+    {'e', "izer", "ize"},
+    {'l', "bli", "ble"},     {'l', "alli", "al"},    {'l', "entli", "ent"},
+    {'l', "eli", "e"},       {'l', "ousli", "ous"},
+    {'o', "ization", "ize"}, {'o', "ation", "ate"},  {'o', "ator", "ate"},
+    {'s', "alism", "al"},    {'s', "iveness", "ive"}, {'s', "fulness", "ful"},
+    {'s', "ousness", "ous"},
+    {'t', "aliti", "al"},    {'t', "iviti", "ive"},  {'t', "biliti", "ble"},
+    {'g', "logi", "log"},
+};
+
+// Step 3: (m>0) suffix -> replacement, keyed by the last letter
+constexpr SuffixRule STEP3_RULES[] = {
+    {'e', "icate", "ic"}, {'e', "ative", ""}, {'e', "alize", "al"},
+    {'i', "iciti", "ic"},
+    {'l', "ical", "ic"},  {'l', "ful", ""},
+    {'s', "ness", ""},
+};
+
+// Step 4: (m>1) suffix -> "", keyed by the penultimate letter.
+// "ion" additionally needs the stem to end in 's' or 't'.
+constexpr SuffixRule STEP4_RULES[] = {
+    {'a', "al", ""},
+    {'c', "ance", ""}, {'c', "ence", ""},
+    {'e', "er", ""},
+    {'i', "ic", ""},
+    {'l', "able", ""}, {'l', "ible", ""},
+    {'n', "ant", ""},  {'n', "ement", ""}, {'n', "ment", ""}, {'n', "ent", ""},
+    {'o', "ion", ""},  {'o', "ou", ""},
+    {'s', "ism", ""},
+    {'t', "ate", ""},  {'t', "iti", ""},
+    {'u', "ous", ""},
+    {'v', "ive", ""},
+    {'z', "ize", ""},
+};
+
+constexpr bool is_vowel(char c) {
+    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+}
+
+// State of one stemming run: b[0..k] is the current word and b[0..j]
+// the stem left by the last successful ends() match
+class Stemming {
+public:
+    Stemming(char* word, int last) : b(word), k(last), j(0) {}
+    
+    int run() {
+        step1ab();
+        if (k > 0) {
+            step1c();
+            apply_rules(STEP2_RULES, b[k - 1]);
+            apply_rules(STEP3_RULES, b[k]);
+            step4();
+            step5();
+        }
+        return k;
+    }
+    
+private:
+    char* b;
+    int k;
+    int j;
+    
+    // 'y' is a consonant at the start of the word or after a vowel;
+    // within a run of 'y's the answer alternates
+    bool cons(int i) const {
+        char c = b[i];
+        if (is_vowel(c)) return false;
+        if (c != 'y') return true;
+        int start = i;
+        while (start > 0 && b[start - 1] == 'y') start--;
+        bool first = (start == 0) || is_vowel(b[start - 1]);
+        return ((i - start) % 2 == 0) ? first : !first;
+    }
+    
+    // Number of VC sequences in b[0..j]
+    int m() const {
+        int n = 0;
+        int i = 0;
+        while (i <= j && cons(i)) i++;
+        while (i <= j) {
+            while (i <= j && !cons(i)) i++;
+            if (i > j) break;
+            while (i <= j && cons(i)) i++;
+            n++;
+        }
+        return n;
+    }
+    
+    bool vowel_in_stem() const {
+        for (int i = 0; i <= j; i++) {
+            if (!cons(i)) return true;
+        }
+        return false;
+    }
+    
+    bool double_consonant(int i) const {
+        return i >= 1 && b[i] == b[i - 1] && cons(i);
+    }
+    
+    // consonant-vowel-consonant ending at i, the last not w, x or y
+    bool cvc(int i) const {
+        if (i < 2 || !cons(i) || cons(i - 1) || !cons(i - 2)) return false;
+        char c = b[i];
+        return c != 'w' && c != 'x' && c != 'y';
+    }
+    
+    bool ends(std::string_view suffix) {
+        int length = static_cast<int>(suffix.size());
+        if (length > k + 1 || suffix.back() != b[k]) return false;
+        if (std::memcmp(b + k - length + 1, suffix.data(), length) != 0) return false;
+        j = k - length;
+        return true;
+    }
+    
+    // Replace b[j+1..k] with s. No rule makes the word longer than it was
+    // on entry, so writes stay inside the caller's buffer
+    void set_to(std::string_view s) {
+        std::memcpy(b + j + 1, s.data(), s.size());
+        k = j + static_cast<int>(s.size());
+    }
+    
+    template <size_t N>
+    void apply_rules(const SuffixRule (&rules)[N], char key) {
+        for (const SuffixRule& rule : rules) {
+            if (rule.key == key && ends(rule.suffix)) {
+                if (m() > 0) set_to(rule.replacement);
+                return;
+            }
+        }
+    }
+    
+    // Plurals and -ed / -ing
+    void step1ab() {
+        if (b[k] == 's') {
+            if (ends("sses")) k -= 2;
+            else if (ends("ies")) set_to("i");
+            else if (b[k - 1] != 's') k--;
+        }
+        if (ends("eed")) {
+            if (m() > 0) k--;
+        } else if ((ends("ed") || ends("ing")) && vowel_in_stem()) {
+            k = j;
+            if (ends("at")) set_to("ate");
+            else if (ends("bl")) set_to("ble");
+            else if (ends("iz")) set_to("ize");
+            else if (double_consonant(k)) {
+                char c = b[k - 1];
+                if (c != 'l' && c != 's' && c != 'z') k--;
+            } else if (m() == 1 && cvc(k)) {
+                set_to("e");
+            }
+        }
+    }
+    
+    // Terminal y -> i when there is another vowel in the stem
+    void step1c() {
+        if (ends("y") && vowel_in_stem()) b[k] = 'i';
+    }
+    
+    void step4() {
+        char key = b[k - 1];
+        for (const SuffixRule& rule : STEP4_RULES) {
+            if (rule.key != key || !ends(rule.suffix)) continue;
+            if (rule.suffix == "ion" && (j < 0 || (b[j] != 's' && b[j] != 't'))) continue;
+            if (m() > 1) k = j;
+            return;
+        }
+    }
+    
+    // Final -e and -ll
+    void step5() {
+        j = k;
+        if (b[k] == 'e') {
+            int a = m();
+            if (a > 1 || (a == 1 && !cvc(k - 1))) k--;
+        }
+        if (b[k] == 'l' && double_consonant(k) && m() > 1) k--;
+    }
+};
+
+} // namespace
+
+size_t PorterStemmer::stem(char* word, size_t length) {
+    // Words of one or two letters are left alone
+    if (length <= 2) return length;
+    return static_cast<size_t>(Stemming(word, static_cast<int>(length) - 1).run()) + 1;
+}
@@ -0,0 +1,27 @@
+#include "../include/ReverseLexicon.hpp"
+
+void ReverseLexicon::set_word(uint32_t word_id, std::string_view word) {
+    if (word_id >= spans.size()) {
+        spans.resize(word_id + 1, Span{0, 0});
+    }
+
+    // Reloading a barrel sets the same words again; keep the blob as is
+    if (get_word(word_id) == word) return;
+
+    spans[word_id] = Span{static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(word.size())};
+    blob.insert(blob.end(), word.begin(), word.end());
+}
+
+void ReverseLexicon::reserve(size_t id_count, size_t blob_bytes) {
+    spans.reserve(id_count);
+    blob.reserve(blob_bytes);
+}
+
+void ReverseLexicon::clear() {
+    spans.clear();
+    blob.clear();
+}
+
+size_t ReverseLexicon::get_memory_bytes() const {
+    return spans.capacity() * sizeof(Span) + blob.capacity();
+}
@@ -0,0 +1,90 @@
+#include "../include/StemCache.hpp"
+#include <iostream>
+#include <iomanip>
+#include <functional>
+
+// the maps are keyed by std::string, so views are copied into a per-thread
+// scratch key first; its capacity is reused, so lookups do not allocate
+static const std::string& lookup_key(std::string_view word) {
+    thread_local std::string key;
+    key.assign(word.data(), word.size());
+    return key;
+}
+
+StemCache::StemCache(size_t capacity, size_t num_shards)
+    : capacity(capacity), hits(0), misses(0), rejected(0) {
+    if (num_shards == 0) num_shards = 1;
+    shard_capacity = (capacity + num_shards - 1) / num_shards;
+    for (size_t i = 0; i < num_shards; i++) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+StemCache::Shard& StemCache::shard_for(const std::string& key) {
+    return *shards[std::hash<std::string>{}(key) % shards.size()];
+}
+
+bool StemCache::lookup(std::string_view word, std::string& stem) {
+    const std::string& key = lookup_key(word);
+    Shard& shard = shard_for(key);
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto found = shard.stems.find(key);
+        if (found != shard.stems.end()) {
+            stem.assign(found->second);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void StemCache::insert(std::string_view word, std::string_view stem) {
+    const std::string& key = lookup_key(word);
+    Shard& shard = shard_for(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    if (shard.stems.size() >= shard_capacity) {
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    shard.stems.emplace(key, std::string(stem));
+}
+
+void StemCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        shard->stems.clear();
+    }
+}
+
+size_t StemCache::get_size() const {
+    size_t size = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        size += shard->stems.size();
+    }
+    return size;
+}
+
+double StemCache::get_hit_rate() const {
+    uint64_t total = hits + misses;
+    return total > 0 ? static_cast<double>(hits) / total : 0.0;
+}
+
+void StemCache::reset_statistics() {
+    hits = 0;
+    misses = 0;
+    rejected = 0;
+}
+
+void StemCache::print_statistics() const {
+    std::cout << "\n=== Stem Cache ===" << std::endl;
+    std::cout << "Entries: " << get_size() << " / " << capacity 
+              << " (" << shards.size() << " shards)" << std::endl;
+    std::cout << "Hits: " << hits << ", misses: " << misses 
+              << ", rejected inserts: " << rejected << std::endl;
+    std::cout << "Hit rate: " << std::fixed << std::setprecision(2) 
+              << 100.0 * get_hit_rate() << "%" << std::endl;
+    std::cout << "==================\n" << std::endl;
+}
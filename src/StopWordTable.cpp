@@ -0,0 +1,165 @@
+#include "../include/StopWordTable.hpp"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+// Common English stop words
+constexpr std::string_view ENGLISH_STOP_WORDS[] = {
+    "a", "about", "above", "after", "again", "against", "all", "am", "an", 
+    "and", "any", "are", "aren't", "as", "at", "be", "because", "been", 
+    "before", "being", "below", "between", "both", "but", "by", "can't", 
+    "cannot", "could", "couldn't", "did", "didn't", "do", "does", "doesn't", 
+    "doing", "don't", "down", "during", "each", "few", "for", "from", 
+    "further", "had", "hadn't", "has", "hasn't", "have", "haven't", "having", 
+    "he", "he'd", "he'll", "he's", "her", "here", "here's", "hers", "herself", 
+    "him", "himself", "his", "how", "how's", "i", "i'd", "i'll", "i'm", 
+    "i've", "if", "in", "into", "is", "isn't", "it", "it's", "its", "itself", 
+    "let's", "me", "more", "most", "mustn't", "my", "myself", "no", "nor", 
+    "not", "of", "off", "on", "once", "only", "or", "other", "ought", "our", 
+    "ours", "ourselves", "out", "over", "own", "same", "shan't", "she", 
+    "she'd", "she'll", "she's", "should", "shouldn't", "so", "some", "such", 
+    "than", "that", "that's", "the", "their", "theirs", "them", "themselves", 
+    "then", "there", "there's", "these", "they", "they'd", "they'll", 
+    "they're", "they've", "this", "those", "through", "to", "too", "under", 
+    "until", "up", "very", "was", "wasn't", "we", "we'd", "we'll", "we're", 
+    "we've", "were", "weren't", "what", "what's", "when", "when's", "where", 
+    "where's", "which", "while", "who", "who's", "whom", "why", "why's", 
+    "with", "won't", "would", "wouldn't", "you", "you'd", "you'll", "you're", 
+    "you've", "your", "yours", "yourself", "yourselves"
+};
+
+// Load factor stays under 40%, so most probes touch a single slot
+constexpr size_t BUILTIN_CAPACITY = 512;
+
+struct BuiltinTable {
+    StopWordTable::Slot slots[BUILTIN_CAPACITY] = {};
+    size_t count = 0;
+    size_t max_length = 0;
+};
+
+constexpr BuiltinTable build_builtin_table() {
+    BuiltinTable table;
+    for (std::string_view word : ENGLISH_STOP_WORDS) {
+        uint32_t h = StopWordTable::hash(word);
+        size_t i = h & (BUILTIN_CAPACITY - 1);
+        bool duplicate = false;
+        while (!table.slots[i].word.empty()) {
+            if (table.slots[i].word == word) duplicate = true;
+            i = (i + 1) & (BUILTIN_CAPACITY - 1);
+        }
+        if (duplicate) continue;
+        table.slots[i].hash = h;
+        table.slots[i].word = word;
+        table.count++;
+        if (word.size() > table.max_length) table.max_length = word.size();
+    }
+    return table;
+}
+
+constexpr BuiltinTable BUILTIN = build_builtin_table();
+static_assert(BUILTIN.count * 2 < BUILTIN_CAPACITY, "built-in stop word table too full");
+
+} // namespace
+
+StopWordTable::StopWordTable()
+    : slots(std::begin(BUILTIN.slots), std::end(BUILTIN.slots)),
+      count(BUILTIN.count), max_length(BUILTIN.max_length) {}
+
+StopWordTable::StopWordTable(const StopWordTable& other)
+    : slots(other.slots), count(other.count), max_length(other.max_length) {
+    // Slots of custom words still view other's storage; copy the words and
+    // swing each slot over to the copy
+    size_t mask = slots.size() - 1;
+    for (const std::string& word : other.custom) {
+        custom.push_back(word);
+        for (size_t i = hash(word) & mask; !slots[i].word.empty(); i = (i + 1) & mask) {
+            if (slots[i].word.data() == word.data()) {
+                slots[i].word = custom.back();
+                break;
+            }
+        }
+    }
+}
+
+StopWordTable& StopWordTable::operator=(const StopWordTable& other) {
+    if (this != &other) {
+        StopWordTable copy(other);
+        slots.swap(copy.slots);
+        custom.swap(copy.custom);   // deque swap keeps element addresses
+        count = copy.count;
+        max_length = copy.max_length;
+    }
+    return *this;
+}
+
+bool StopWordTable::add(std::string_view word) {
+    if (word.empty() || contains(word)) return false;
+    
+    if ((count + 1) * 2 > slots.size()) {
+        grow();
+    }
+    
+    custom.emplace_back(word);
+    insert_slot(Slot{hash(word), custom.back()});
+    count++;
+    max_length = std::max(max_length, word.size());
+    return true;
+}
+
+int StopWordTable::load_from_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open stop word list " << path << std::endl;
+        return -1;
+    }
+    
+    int added = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        // Trim whitespace and skip comments
+        line.erase(0, line.find_first_not_of(" \t\r\n"));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        if (line.empty() || line[0] == '#') continue;
+        
+        std::transform(line.begin(), line.end(), line.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (add(line)) added++;
+    }
+    return added;
+}
+
+void StopWordTable::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{});
+    custom.clear();
+    count = 0;
+    max_length = 0;
+}
+
+std::vector<std::string_view> StopWordTable::get_words() const {
+    std::vector<std::string_view> words;
+    words.reserve(count);
+    for (const Slot& slot : slots) {
+        if (!slot.word.empty()) words.push_back(slot.word);
+    }
+    return words;
+}
+
+void StopWordTable::insert_slot(const Slot& entry) {
+    size_t mask = slots.size() - 1;
+    size_t i = entry.hash & mask;
+    while (!slots[i].word.empty()) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = entry;
+}
+
+void StopWordTable::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot{});
+    for (const Slot& entry : old) {
+        if (!entry.word.empty()) insert_slot(entry);
+    }
+}
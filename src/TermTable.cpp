@@ -0,0 +1,75 @@
+#include "../include/TermTable.hpp"
+#include <functional>
+
+TermTable::TermTable() : offsets(1, 0), slots(16, Slot{0, NPOS}) {}
+
+uint32_t TermTable::hash_term(std::string_view word) {
+    size_t h = std::hash<std::string_view>{}(word);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+uint32_t TermTable::find(std::string_view word) const {
+    uint32_t h = hash_term(word);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.index == NPOS) return NPOS;
+        if (slot.hash == h && equals(slot.index, word)) return slot.index;
+    }
+}
+
+uint32_t TermTable::insert(std::string_view word, bool& inserted) {
+    uint32_t h = hash_term(word);
+    size_t mask = slots.size() - 1;
+    size_t i = h & mask;
+    for (; slots[i].index != NPOS; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.hash == h && equals(slot.index, word)) {
+            inserted = false;
+            return slot.index;
+        }
+    }
+    
+    // New term: append its bytes to the arena and take the free slot
+    uint32_t index = static_cast<uint32_t>(size());
+    arena.insert(arena.end(), word.begin(), word.end());
+    offsets.push_back(static_cast<uint32_t>(arena.size()));
+    slots[i] = Slot{h, index};
+    inserted = true;
+    
+    if (size() * 4 > slots.size() * 3) {
+        rehash(slots.size() * 2);
+    }
+    return index;
+}
+
+void TermTable::reserve(size_t term_count, size_t arena_bytes) {
+    offsets.reserve(term_count + 1);
+    arena.reserve(arena_bytes);
+    size_t slot_count = slots.size();
+    while (term_count * 4 > slot_count * 3) slot_count *= 2;
+    if (slot_count != slots.size()) rehash(slot_count);
+}
+
+void TermTable::clear() {
+    arena.clear();
+    offsets.assign(1, 0);
+    slots.assign(16, Slot{0, NPOS});
+}
+
+size_t TermTable::get_memory_bytes() const {
+    return arena.capacity() + offsets.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(Slot);
+}
+
+void TermTable::rehash(size_t slot_count) {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(slot_count, Slot{0, NPOS});
+    size_t mask = slot_count - 1;
+    for (const Slot& slot : old) {
+        if (slot.index == NPOS) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].index != NPOS) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
@@ -0,0 +1,84 @@
+#include "../include/TokenSinks.hpp"
+#include <algorithm>
+
+DocumentTermSink::DocumentTermSink(LexiconBuilder& lexicon, bool grow_lexicon)
+    : lexicon(lexicon), grow_lexicon(grow_lexicon), doc_length(0) {}
+
+void DocumentTermSink::operator()(std::string_view token) {
+    uint32_t word_id = grow_lexicon ? lexicon.add_word(token, 1) : lexicon.get_word_id(token);
+    if (word_id == UINT32_MAX) return;
+    
+    if (word_id >= counts.size()) {
+        counts.resize(std::max<size_t>(word_id + 1, counts.size() * 2), 0);
+    }
+    if (counts[word_id]++ == 0) {
+        touched.push_back(word_id);
+    }
+    doc_length++;
+}
+
+uint32_t DocumentTermSink::take_document(std::vector<TermPosting>& terms) {
+    std::sort(touched.begin(), touched.end());
+    
+    terms.clear();
+    terms.reserve(touched.size());
+    for (uint32_t word_id : touched) {
+        terms.emplace_back(word_id, counts[word_id]);
+        counts[word_id] = 0;
+    }
+    touched.clear();
+    
+    uint32_t length = doc_length;
+    doc_length = 0;
+    return length;
+}
+
+// The local cache is dropped once it grows past this many words; later
+// sightings then go back to the shared lexicon, which is always correct
+static const size_t LOCAL_CACHE_LIMIT = 1 << 20;
+
+ConcurrentTermSink::ConcurrentTermSink(ConcurrentLexicon& lexicon)
+    : lexicon(lexicon), doc_seq(0), doc_length(0) {}
+
+void ConcurrentTermSink::begin_document(uint64_t seq) {
+    doc_seq = seq;
+    doc_length = 0;
+}
+
+void ConcurrentTermSink::operator()(std::string_view token) {
+    if (seen.size() >= LOCAL_CACHE_LIMIT) {
+        seen.clear();
+        seen_ids.clear();
+    }
+    
+    bool inserted = false;
+    uint32_t local = seen.insert(token, inserted);
+    if (inserted) {
+        // First sight in this thread; later ones are never earlier, so the
+        // shared first-seen key only needs this position
+        seen_ids.push_back(lexicon.add_word(token, ConcurrentLexicon::make_first_seen(doc_seq, doc_length)));
+    }
+    uint32_t word_id = seen_ids[local];
+    
+    if (word_id >= counts.size()) {
+        counts.resize(std::max<size_t>(word_id + 1, counts.size() * 2), 0);
+    }
+    if (counts[word_id]++ == 0) {
+        touched.push_back(word_id);
+    }
+    doc_length++;
+}
+
+uint32_t ConcurrentTermSink::take_document(std::vector<TermPosting>& terms) {
+    terms.clear();
+    terms.reserve(touched.size());
+    for (uint32_t word_id : touched) {
+        terms.emplace_back(word_id, counts[word_id]);
+        counts[word_id] = 0;
+    }
+    touched.clear();
+    
+    uint32_t length = doc_length;
+    doc_length = 0;
+    return length;
+}
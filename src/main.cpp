@@ -1,8 +1,13 @@
 #include "../include/metadataparser.hpp"
 #include "../include/TextPreProcessor.hpp"
 #include "../include/LexiconBuilder.hpp"
+#include "../include/MappedLexicon.hpp"
+#include "../include/FstLexicon.hpp"
+#include "../include/DocumentStore.hpp"
 #include "../include/ForwardIndex.hpp"
 #include "../include/InvertedIndex.hpp"
+#include "../include/IndexBuilder.hpp"
+#include "../include/Benchmarks.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -10,100 +15,77 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <chrono>
+
+int main(int argc, char* argv[]) {
+    // =================== Benchmark Mode ===================
+    // main bench <name> <path>
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return run_benchmark(argc > 2 ? argv[2] : "", argc > 3 ? argv[3] : "");
+    }
 
-int main() {
     // =================== Configuration ===================
     std::string dataset_path = "D:\\THird Semester\\DSA\\dsaspp\\DSAPROJECT\\data\\2020-04-10";
     std::string indices_path = "D:\\THird Semester\\DSA\\dsaspp\\DSAPROJECT\\indices\\";
+    if (argc > 1) dataset_path = argv[1];
+    if (argc > 2) indices_path = std::string(argv[2]) + "/";
+    unsigned index_threads = 0;      // tokenizer threads, 0 = one per core
+    if (argc > 3) index_threads = static_cast<unsigned>(std::stoul(argv[3]));
+    unsigned parse_threads = 0;      // full-text extraction threads, 0 = one per core
+    if (argc > 4) parse_threads = static_cast<unsigned>(std::stoul(argv[4]));
     std::string barrel_path = indices_path + "inverted_index_barrels";
     
-    const int MAX_DOCS = 2000;  // Only process 2000 documents
+    const size_t MAX_DOCS = 0;       // 0 = index the whole corpus
+    const size_t BATCH_SIZE = 256;   // Papers in memory at once while streaming
 
-    // =================== Step 1: Parse Metadata ===================
-    std::cout << "=== Parsing Metadata ===" << std::endl;
+    // =================== Step 1+2+3: Stream Papers into Lexicon and Forward Index ===================
+    // Papers are streamed in batches and each body is tokenized exactly once
+    // (batches in parallel); a batch is dropped as soon as it has been indexed.
+    std::cout << "=== Parsing Metadata and Building Lexicon + Forward Index ===" << std::endl;
     MetadataParser parser(dataset_path);
-    parser.metadata_parse();
-    
-    // Get only first 2000 papers
-    auto all_papers = parser.getPapers();
-    int actual_limit = std::min(MAX_DOCS, (int)all_papers.size());
-    std::vector<Paper> papers_subset(all_papers.begin(), 
-                                     all_papers.begin() + actual_limit);
-    
-    std::cout << "Total papers parsed: " << all_papers.size() << std::endl;
-    std::cout << "Using only first " << papers_subset.size() << " documents for indexing" << std::endl;
-
-    // =================== Step 2: Build Lexicon (2000 docs only) ===================
-    std::cout << "\n=== Building Lexicon from " << papers_subset.size() << " documents ===" << std::endl;
-    TextPreprocessor preprocessor;
-    LexiconBuilder lexicon;
+    parser.set_num_threads(parse_threads);
+    IndexBuilder builder;
+    builder.set_num_threads(index_threads);
+    builder.open_document_store(indices_path + "documents.bin");
     
-    for (const auto& paper : papers_subset) {
-        std::vector<std::string> tokens = preprocessor.preprocess(paper.body_text);
-        for (const auto& token : tokens) {
-            lexicon.add_word(token, 1);
+    int total_papers = parser.for_each_batch([&](std::vector<Paper>& batch) {
+        uint32_t before = builder.get_indexed_documents();
+        builder.add_papers(batch);
+        uint32_t processed_docs = builder.get_indexed_documents();
+        if (processed_docs / 500 != before / 500) {
+            std::cout << "Processed " << processed_docs << " documents..." << std::endl;
         }
-    }
+    }, BATCH_SIZE, MAX_DOCS);
     
-    lexicon.save_to_csv(indices_path + "lexicon.csv");
+    LexiconBuilder& lexicon = builder.get_lexicon();
+    std::cout << "Total papers streamed: " << total_papers << std::endl;
     std::cout << "Lexicon size: " << lexicon.get_size() << " unique words" << std::endl;
-
-    // =================== Step 3: Build Forward Index (2000 docs only) ===================
-    std::cout << "\n=== Building Forward Index ===" << std::endl;
-    ForwardIndex forward_index;
-    int processed_docs = 0;
-    
-    for (const auto& paper : papers_subset) {
-        std::vector<std::string> tokens = preprocessor.preprocess(paper.body_text);
-        std::vector<uint32_t> word_ids;
-        word_ids.reserve(tokens.size());
-
-        for (const auto& token : tokens) {
-            uint32_t word_id = lexicon.get_word_id(token);
-            if (word_id != UINT32_MAX) {
-                word_ids.push_back(word_id);
-            }
-        }
-
-        if (!word_ids.empty()) {
-            forward_index.add_document(paper.paper_id, paper.title, paper.abstract_text, word_ids);
-            processed_docs++;
-            if (processed_docs % 500 == 0) {
-                std::cout << "Processed " << processed_docs << " documents..." << std::endl;
-            }
-        }
-    }
     
     std::cout << "Forward index built successfully!" << std::endl;
-    forward_index.print_statistics();
-    forward_index.save_to_binary(indices_path + "forward_index.bin");
+    builder.get_forward_index().print_statistics();
 
-    // =================== Step 4: Build Inverted Index (2000 docs only) ===================
-    std::cout << "\n=== Building Inverted Index ===" << std::endl;
-    std::unordered_map<uint32_t, std::string> reverse_lex = lexicon.build_reverse_lexicon();
-    InvertedIndex inverted_index;
-
-    for (const auto& [doc_id_str, doc_num_id] : forward_index.get_doc_id_map()) {
-        const DocumentIndex* doc = forward_index.get_document(doc_id_str);
-        if (!doc) continue;
-
-        std::vector<std::pair<uint32_t, uint32_t>> terms;
-        for (const auto& t : doc->terms) {
-            terms.emplace_back(t.word_id, t.frequency);
-        }
-        inverted_index.add_document(doc_num_id, terms);
-    }
+    // Hot terms get the smallest ids, so they share cache lines and barrel 0
+    builder.renumber_by_frequency();
+    std::cout << "Word ids renumbered by collection frequency" << std::endl;
 
-    inverted_index.save_to_binary(indices_path + "inverted_index.bin", reverse_lex);
+    // =================== Step 4: Build Inverted Index ===================
+    std::cout << "\n=== Building Inverted Index ===" << std::endl;
+    builder.build_inverted_index();
+    builder.save(indices_path);
+    
+    InvertedIndex& inverted_index = builder.get_inverted_index();
+    const ReverseLexicon& reverse_lex = builder.get_reverse_lexicon();
     inverted_index.print_statistics();
 
-    // =================== Step 5: Create Barrels (2000 docs) ===================
+    // =================== Step 5: Create Barrels ===================
     std::cout << "\n=== Creating Barrels ===" << std::endl;
-    inverted_index.create_barrels(barrel_path, reverse_lex, 4);
+    builder.create_barrels(barrel_path, 4);
     inverted_index.print_barrel_info();
+    builder.print_timing();
 
-    // =================== Step 6: Export Barrels to CSV for Submission ===================
+    // =================== Step 6: Export Lexicon and Barrels to CSV for Submission ===================
     std::cout << "\n=== Exporting Barrels to CSV ===" << std::endl;
+    lexicon.save_to_csv(indices_path + "lexicon.csv");
     
     // Load metadata and export each barrel to CSV
     InvertedIndex export_idx;
@@ -119,15 +101,14 @@ int main() {
         std::ofstream csv_out(csv_path);
         csv_out << "word_id,word,doc_id,frequency\n";
         
-        auto barrel_data = export_idx.get_inverted_index();
-        for (const auto& [word_id, postings] : barrel_data) {
-            std::string word = reverse_lex[word_id];
+        export_idx.for_each_term([&](uint32_t word_id, PostingList postings) {
+            std::string_view word = export_idx.get_word(word_id, reverse_lex);
             for (const auto& [doc_id, freq] : postings) {
                 csv_out << word_id << "," << word << "," << doc_id << "," << freq << "\n";
             }
-        }
+        });
         csv_out.close();
-        std::cout << "Exported Barrel " << i << " to CSV (" << barrel_data.size() << " words)" << std::endl;
+        std::cout << "Exported Barrel " << i << " to CSV (" << export_idx.get_term_count() << " words)" << std::endl;
     }
 
     // =================== Step 7: Test Barrel Queries ===================
@@ -136,13 +117,28 @@ int main() {
     InvertedIndex query_idx;
     query_idx.load_barrel_metadata(barrel_path);
     query_idx.print_barrel_info();
+    
+    // Queries resolve words through the mapped lexicon.bin, as a query process would
+    auto open_start = std::chrono::steady_clock::now();
+    MappedLexicon query_lexicon;
+    if (!query_lexicon.open(indices_path + "lexicon.bin")) {
+        return 1;
+    }
+    std::cout << "Opened lexicon.bin (" << query_lexicon.get_size() << " words) in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - open_start).count()
+              << " ms" << std::endl;
+
+    // Titles for display come from the document store, one block at a time
+    DocumentStore document_store;
+    document_store.open(indices_path + "documents.bin");
+    StoredDocument stored;
 
     // Test with actual words from lexicon
     std::vector<std::string> test_words = {"virus", "infection", "cells", "protein", "patients"};
     
     std::cout << "\n=== Testing Words ===" << std::endl;
     for (const auto& word : test_words) {
-        uint32_t word_id = lexicon.get_word_id(word);
+        uint32_t word_id = query_lexicon.get_word_id(word);
         
         if (word_id == UINT32_MAX) {
             std::cout << "Word '" << word << "' not found in lexicon" << std::endl;
@@ -150,21 +146,41 @@ int main() {
         }
         
         std::cout << "\n--- Searching: '" << word << "' (ID: " << word_id << ") ---" << std::endl;
+        TermStats stats = query_lexicon.get_term_stats(word_id);
+        std::cout << "df " << stats.document_frequency << ", cf " << stats.collection_frequency
+                  << ", max tf " << stats.max_term_frequency << ", postings "
+                  << stats.posting_bytes << " bytes" << std::endl;
         query_idx.load_barrel_for_word(word_id, reverse_lex);
         
-        const auto* postings = query_idx.get_terms(word_id);
+        PostingList postings = query_idx.get_postings(word_id);
         
-        if (postings) {
-            std::cout << "Found in " << postings->size() << " documents" << std::endl;
+        if (!postings.empty()) {
+            std::cout << "Found in " << postings.size() << " documents" << std::endl;
             
             size_t count = 0;
-            for (const auto& [doc_id, freq] : *postings) {
-                std::cout << "  Doc " << doc_id << ": " << freq << " times" << std::endl;
+            for (const auto& [doc_id, freq] : postings) {
+                std::cout << "  Doc " << doc_id << ": " << freq << " times";
+                if (document_store.get_document(doc_id, stored) && !stored.title.empty()) {
+                    std::cout << " - " << stored.title.substr(0, 60);
+                }
+                std::cout << std::endl;
                 if (++count >= 5) break;
             }
         }
     }
 
-    std::cout << "\n=== Processing Complete for " << papers_subset.size() << " documents ===" << std::endl;
+    // Prefix completion from the FST lexicon
+    FstLexicon prefix_lexicon;
+    if (prefix_lexicon.open(indices_path + "lexicon.fst")) {
+        std::cout << "\n=== Prefix Search: 'corona' ===" << std::endl;
+        size_t shown = 0;
+        size_t total = prefix_lexicon.for_each_prefix("corona", [&](std::string_view word, uint32_t word_id) {
+            if (shown++ < 10) std::cout << "  " << word << " (ID: " << word_id << ")" << std::endl;
+            return true;
+        });
+        std::cout << total << " words start with 'corona'" << std::endl;
+    }
+
+    std::cout << "\n=== Processing Complete for " << builder.get_indexed_documents() << " documents ===" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -1,160 +1,301 @@
 #include "../include/metadataparser.hpp"
+#include "../include/MappedFile.hpp"
+#include "../include/CsvReader.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <filesystem>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
 
 // For JSON parsing - you'll need nlohmann/json library
 #include <nlohmann_json.hpp>
 
-namespace fs = std::filesystem;
 using json = nlohmann::json;
 
+MetadataParser::MetadataParser(const std::string& data_path)
+    : data_path(data_path), num_threads(0) {
+    set_num_threads(0);
+}
+
+MetadataParser::~MetadataParser() {
+    stop_pool();
+}
+
+void MetadataParser::set_num_threads(unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    threads = std::max(1u, threads);
+    if (threads != num_threads) {
+        stop_pool();   // the next batch starts it at the new size
+    }
+    num_threads = threads;
+}
+
+void MetadataParser::run_on_pool(const std::function<void()>& job) {
+    if (workers.empty()) {
+        for (unsigned t = 1; t < num_threads; t++) {
+            workers.emplace_back(&MetadataParser::pool_loop, this, pool_generation);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_job = &job;
+        pool_busy = workers.size();
+        pool_generation++;
+    }
+    pool_wake.notify_all();
+    
+    job(); // calling thread is worker 0
+    
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    pool_done.wait(lock, [this]() { return pool_busy == 0; });
+    pool_job = nullptr;
+}
+
+void MetadataParser::pool_loop(uint64_t generation) {
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    for (;;) {
+        pool_wake.wait(lock, [&]() { return pool_stop || pool_generation != generation; });
+        if (pool_stop) return;
+        generation = pool_generation;
+        const std::function<void()>& job = *pool_job;
+        
+        lock.unlock();
+        job();
+        lock.lock();
+        
+        if (--pool_busy == 0) {
+            pool_done.notify_one();
+        }
+    }
+}
+
+void MetadataParser::stop_pool() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_stop = true;
+    }
+    pool_wake.notify_all();
+    for (auto& t : workers) {
+        t.join();
+    }
+    workers.clear();
+    pool_stop = false;
+}
+
+namespace {
+
+// metadata.csv columns used by the parser, looked up by header name
+// (falls back to the CORD-19 column order if a name is missing)
+struct MetadataColumns {
+    int cord_uid, sha, title, pmcid, abstract_text, publish_time, authors;
+    int required;   // highest index a row must have
+
+    explicit MetadataColumns(const CsvReader& reader) {
+        auto col = [&](const char* name, int fallback) {
+            int index = reader.column_index(name);
+            return index >= 0 ? index : fallback;
+        };
+        cord_uid = col("cord_uid", 0);
+        sha = col("sha", 1);
+        title = col("title", 3);
+        pmcid = col("pmcid", 5);
+        abstract_text = col("abstract", 8);
+        publish_time = col("publish_time", 9);
+        authors = col("authors", 10);   // optional
+        required = std::max({cord_uid, sha, title, pmcid, abstract_text, publish_time});
+    }
+};
+
+// Field as a trimmed std::string ("" unescaped)
+std::string field_text(const CsvReader& reader, int column, std::string& scratch) {
+    std::string_view field = reader.field_unescaped(column, scratch);
+    
+    size_t first = field.find_first_not_of(" \t\n\r");
+    if (first == std::string_view::npos) return "";
+    size_t last = field.find_last_not_of(" \t\n\r");
+    return std::string(field.substr(first, last - first + 1));
+}
+
+} // namespace
+
 int MetadataParser::metadata_stats() {
     std::string metadata_path = data_path + "/metadata.csv";
     
-    std::ifstream file(metadata_path);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open " << metadata_path << std::endl;
+    CsvReader reader;
+    if (!reader.open(metadata_path)) {
         return 0;
     }
     
+    // Counts records, so quoted multi-line abstracts count once
     int count = 0;
-    std::string line;
-    std::getline(file, line); // Skip header
-    
-    while (std::getline(file, line)) {
-        if (!line.empty()) count++;
+    while (reader.next_row()) {
+        count++;
     }
     
-    file.close();
     return count;
 }
 
 int MetadataParser::metadata_parse() {
+    int parsed_count = for_each_paper([this](Paper& paper) {
+        papers.push_back(std::move(paper));
+    });
+    
+    return parsed_count;
+}
+
+int MetadataParser::for_each_paper(const std::function<void(Paper&)>& visitor,
+                                   size_t batch_size, size_t max_docs) {
+    return for_each_batch([&](std::vector<Paper>& batch) {
+        for (auto& paper : batch) {
+            visitor(paper);
+        }
+    }, batch_size, max_docs);
+}
+
+int MetadataParser::for_each_batch(const std::function<void(std::vector<Paper>&)>& visitor,
+                                   size_t batch_size, size_t max_docs) {
     std::string metadata_path = data_path + "/metadata.csv";
     
-    std::ifstream file(metadata_path);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open " << metadata_path << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
+    
+    CsvReader reader;
+    if (!reader.open(metadata_path)) {
         return 0;
     }
     
-    std::string line;
-    std::getline(file, line); // Skip header
+    MetadataColumns columns(reader);
+    std::string scratch;
+    batch_size = std::max<size_t>(1, batch_size);
+    
+    // Resolve full-text files against a one-time directory listing
+    ensure_catalog();
+    catalog.reset_statistics();
+    
+    // Only one batch of papers (and their full-text files) is alive at a time
+    std::vector<Paper> batch;
+    std::vector<FullTextFiles> sources;
+    batch.reserve(batch_size);
     
     int parsed_count = 0;
     int full_text_count = 0;
+    bool done = false;
     
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::vector<std::string> fields;
-        parse_csv_line(line, fields);
-        
-        if (fields.size() < 10) continue;
-        
-        Paper paper;
+    while (!done) {
+        batch.clear();
+        sources.clear();
         
-        // Extract basic metadata
-        // Assuming CSV format: cord_uid, sha, source_x, title, doi, pmcid, pubmed_id, license, abstract, publish_time, authors, journal...
-        paper.paper_id = clean_field(fields[0]);     // cord_uid
-        std::string sha = clean_field(fields[1]);     // sha
-        paper.title = clean_field(fields[3]);         // title
-        std::string pmcid = clean_field(fields[5]);   // pmcid
-        paper.abstract_text = clean_field(fields[8]); // abstract
-        paper.publish_date = clean_field(fields[9]);  // publish_time
-        
-        if (fields.size() > 10) {
-            paper.authors = clean_field(fields[10]);  // authors
-        }
-        
-        // Try to extract full body text from JSON files
-        std::string full_text;
-        
-        // Try PDF JSON first (using SHA)
-        if (!sha.empty()) {
-            full_text = find_fulltext_pdf(sha);
+        // Fill the next batch sequentially from metadata.csv
+        while (batch.size() < batch_size && reader.next_row()) {
+            if (static_cast<int>(reader.field_count()) <= columns.required) continue;
+            
+            Paper paper;
+            
+            // Extract basic metadata
+            paper.paper_id = field_text(reader, columns.cord_uid, scratch);
+            paper.title = field_text(reader, columns.title, scratch);
+            paper.abstract_text = field_text(reader, columns.abstract_text, scratch);
+            paper.publish_date = field_text(reader, columns.publish_time, scratch);
+            
+            if (columns.authors < static_cast<int>(reader.field_count())) {
+                paper.authors = field_text(reader, columns.authors, scratch);
+            }
+            
+            sources.push_back(catalog.resolve(field_text(reader, columns.sha, scratch),
+                                              field_text(reader, columns.pmcid, scratch)));
+            batch.push_back(std::move(paper));
+            
+            if (max_docs != 0 && parsed_count + batch.size() >= max_docs) break;
         }
         
-        // If not found, try PMC JSON
-        if (full_text.empty() && !pmcid.empty()) {
-            full_text = find_fulltext_xml(pmcid);
+        if (batch.size() < batch_size || 
+            (max_docs != 0 && parsed_count + batch.size() >= max_docs)) {
+            done = true;
         }
+        if (batch.empty()) break;
         
-        if (!full_text.empty()) {
-            paper.body_text = full_text;
-            full_text_count++;
-        }
-
-        /*std::cout << "Parsed paper: " << paper.paper_id
-          << " | Title: " << paper.title << "\n";*/
-
+        full_text_count += extract_fulltext_batch(batch, sources);
         
-        papers.push_back(paper);
-        parsed_count++;
-        //std::cout << paper.body_text << std::endl;
-
+        // Hand the batch to the consumer; papers stay in metadata.csv order
+        visitor(batch);
+        int previous_count = parsed_count;
+        parsed_count += static_cast<int>(batch.size());
         
-        if (parsed_count % 1000 == 0) {
+        if (parsed_count / 1000 != previous_count / 1000) {
             std::cout << "Parsed " << parsed_count << " papers (with full text: " 
                       << full_text_count << ")..." << std::endl;
         }
     }
     
-    file.close();
+    reader.close();
+    
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
     
     std::cout << "\nParsing complete!" << std::endl;
     std::cout << "Total papers: " << parsed_count << std::endl;
     std::cout << "Papers with full text: " << full_text_count << std::endl;
+    std::cout << "Ingestion time: " << seconds << " s (" 
+              << (seconds > 0 ? parsed_count / seconds : 0.0) << " docs/sec, "
+              << num_threads << " threads)" << std::endl;
+    catalog.print_statistics();
     
     return parsed_count;
 }
 
-void MetadataParser::parse_csv_line(const std::string& line, 
-                                    std::vector<std::string>& parsed_line) {
-    parsed_line.clear();
-    std::string field;
-    bool in_quotes = false;
+int MetadataParser::extract_fulltext_batch(std::vector<Paper>& batch,
+                                           const std::vector<FullTextFiles>& sources) {
+    // Workers claim rows from a shared counter and write the body text into
+    // the paper's own slot, so batch order never changes
+    std::atomic<size_t> next_row(0);
+    std::atomic<int> full_text_count(0);
     
-    for (size_t i = 0; i < line.length(); i++) {
-        char c = line[i];
-        
-        if (c == '"') {
-            in_quotes = !in_quotes;
-        } else if (c == ',' && !in_quotes) {
-            parsed_line.push_back(field);
-            field.clear();
-        } else {
-            field += c;
+    auto worker = [&]() {
+        size_t row;
+        while ((row = next_row.fetch_add(1)) < batch.size()) {
+            std::string_view full_text = extract_fulltext_view(sources[row]);
+            
+            if (!full_text.empty()) {
+                batch[row].body_text.assign(full_text.data(), full_text.size());
+                full_text_count++;
+            }
         }
-    }
-    parsed_line.push_back(field);
-}
-
-std::string MetadataParser::clean_field(const std::string& field) {
-    std::string cleaned = field;
+    };
     
-    // Remove leading/trailing whitespace
-    cleaned.erase(0, cleaned.find_first_not_of(" \t\n\r"));
-    cleaned.erase(cleaned.find_last_not_of(" \t\n\r") + 1);
+    // Pool threads that find no row left return at once, so a short
+    // final batch costs one wake-up per thread, not a thread start
+    run_on_pool(worker);
     
-    // Remove surrounding quotes
-    if (!cleaned.empty() && cleaned.front() == '"' && cleaned.back() == '"') {
-        cleaned = cleaned.substr(1, cleaned.length() - 2);
-    }
-    
-    return cleaned;
+    return full_text_count;
+}
+
+std::string MetadataParser::pdf_json_dir() const {
+    // CORD-19 structure: document_parses/pdf_json/{sha}.json
+    return data_path + "/comm_use_subset/pdf_json";
+}
+
+std::string MetadataParser::pmc_json_dir() const {
+    // CORD-19 structure: document_parses/pmc_json/{pmcid}.xml.json
+    return data_path + "/comm_use_subset/pmc_json";
+}
+
+void MetadataParser::ensure_catalog() {
+    std::call_once(catalog_once, [this]() {
+        catalog.build(pdf_json_dir(), pmc_json_dir());
+    });
 }
 
 std::string MetadataParser::find_fulltext_pdf(const std::string& sha) {
     if (sha.empty()) return "";
     
-    // CORD-19 structure: document_parses/pdf_json/{sha}.json
-    std::string json_path = data_path + "/comm_use_subset/pdf_json/" + sha + ".json";
+    ensure_catalog();
+    std::string json_path = catalog.resolve_pdf(sha);
     
-    if (fs::exists(json_path)) {
+    if (!json_path.empty()) {
         return extract_body_from_json(json_path);
     }
     
@@ -164,17 +305,187 @@ std::string MetadataParser::find_fulltext_pdf(const std::string& sha) {
 std::string MetadataParser::find_fulltext_xml(const std::string& pmcid) {
     if (pmcid.empty()) return "";
     
-    // CORD-19 structure: document_parses/pmc_json/{pmcid}.xml.json
-    std::string json_path = data_path + "/comm_use_subset/pmc_json/" + pmcid + ".xml.json";
+    ensure_catalog();
+    std::string json_path = catalog.resolve_pmc(pmcid);
     
-    if (fs::exists(json_path)) {
+    if (!json_path.empty()) {
         return extract_body_from_json(json_path);
     }
     
     return "";
 }
 
+std::string MetadataParser::find_fulltext(const std::string& sha, const std::string& pmcid) {
+    return std::string(find_fulltext_view(sha, pmcid));
+}
+
+std::string_view MetadataParser::find_fulltext_view(const std::string& sha, const std::string& pmcid) {
+    ensure_catalog();
+    
+    FullTextFiles files;
+    files.pdf_path = catalog.resolve_pdf(sha);
+    files.pmc_path = catalog.resolve_pmc(pmcid);
+    
+    return extract_fulltext_view(files);
+}
+
+std::string_view MetadataParser::extract_fulltext_view(const FullTextFiles& files) {
+    std::string_view full_text;
+    
+    // Try PDF JSON first
+    if (!files.pdf_path.empty()) {
+        full_text = extract_body_view(files.pdf_path);
+    }
+    
+    // If not found, try PMC JSON
+    if (full_text.empty() && !files.pmc_path.empty()) {
+        full_text = extract_body_view(files.pmc_path);
+    }
+    
+    return full_text;
+}
+
+namespace {
+
+// SAX handler that keeps only abstract[].text and body_text[].text.
+// Everything else (metadata, bib_entries, ref_entries, cite_spans, ...) is
+// skipped by depth tracking without building any DOM nodes.
+class BodyTextSax : public nlohmann::json_sax<json> {
+public:
+    explicit BodyTextSax(std::string& out) : out(out), start(out.size()) {}
+
+    bool null() override { return value_done(); }
+    bool boolean(bool) override { return value_done(); }
+    bool number_integer(number_integer_t) override { return value_done(); }
+    bool number_unsigned(number_unsigned_t) override { return value_done(); }
+    bool number_float(number_float_t, const string_t&) override { return value_done(); }
+    bool binary(binary_t&) override { return value_done(); }
+
+    bool string(string_t& val) override {
+        if (want_text) {
+            std::string& dst = (section_kind == ABSTRACT && seen_body) ? late_abstract : out;
+            dst.append(val);
+            dst.append("\n\n");
+        }
+        return value_done();
+    }
+
+    bool start_object(std::size_t) override {
+        depth++;
+        want_text = false;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth == 1) {
+            pending_kind = (val == "abstract") ? ABSTRACT :
+                           (val == "body_text") ? BODY : NONE;
+        }
+        // "text" directly inside a section object (not e.g. cite_spans[].text)
+        want_text = section_kind != NONE && depth == section_array_depth + 1 && val == "text";
+        return true;
+    }
+
+    bool end_object() override {
+        depth--;
+        want_text = false;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        depth++;
+        // Array directly under the root "abstract" / "body_text" key
+        if (depth == 2 && pending_kind != NONE) {
+            section_kind = pending_kind;
+            section_array_depth = depth;
+            if (section_kind == BODY) seen_body = true;
+        }
+        pending_kind = NONE;
+        want_text = false;
+        return true;
+    }
+
+    bool end_array() override {
+        if (section_kind != NONE && depth == section_array_depth) {
+            section_kind = NONE;
+        }
+        depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = ex.what();
+        return false;
+    }
+
+    // Abstract sections always precede body sections, matching the DOM path
+    void finish() {
+        if (!late_abstract.empty()) {
+            out.insert(start, late_abstract);
+        }
+    }
+
+    std::string error;
+
+private:
+    enum SectionKind { NONE, ABSTRACT, BODY };
+
+    // A scalar value was consumed: a pending root key no longer applies
+    bool value_done() {
+        if (depth == 1) pending_kind = NONE;
+        want_text = false;
+        return true;
+    }
+
+    std::string& out;
+    size_t start;                  // where this paper's text begins in out
+    std::string late_abstract;     // abstract found after body_text
+    int depth = 0;
+    int section_array_depth = 0;
+    SectionKind pending_kind = NONE;
+    SectionKind section_kind = NONE;
+    bool want_text = false;
+    bool seen_body = false;
+};
+
+} // namespace
+
 std::string MetadataParser::extract_body_from_json(const std::string& json_path) {
+    std::string body_text;
+    append_body_from_json(json_path, body_text);
+    return body_text;
+}
+
+bool MetadataParser::append_body_from_json(const std::string& json_path, std::string& body_text) {
+    // One mapping per thread; its pread fallback buffer is reused across files
+    thread_local MappedFile file;
+    if (!file.open(json_path)) {
+        return false;
+    }
+    
+    size_t start_size = body_text.size();
+    BodyTextSax handler(body_text);
+    bool ok = json::sax_parse(file.data(), file.data() + file.size(), &handler);
+    file.close();
+    
+    if (!ok) {
+        std::cerr << "Error parsing JSON " << json_path << ": " << handler.error << std::endl;
+        body_text.resize(start_size);
+        return false;
+    }
+    handler.finish();
+    return true;
+}
+
+std::string_view MetadataParser::extract_body_view(const std::string& json_path) {
+    // Per-thread scratch buffer; its capacity is kept from paper to paper
+    thread_local std::string buffer;
+    buffer.clear();
+    append_body_from_json(json_path, buffer);
+    return buffer;
+}
+
+std::string MetadataParser::extract_body_from_json_dom(const std::string& json_path) {
     std::ifstream file(json_path);
     if (!file.is_open()) {
         return "";